@@ -0,0 +1,963 @@
+// Benchmarks for the version3_no.cpp classes.
+// Build: g++ -std=c++17 -O2 -mavx2 -pthread -o benchmark benchmark.cpp
+#define EMS_NO_MAIN
+#include "version3_no.cpp"
+
+#include <chrono>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+
+#ifdef __GLIBC__
+#include <malloc.h> // For malloc_trim
+#endif
+
+#ifdef _WIN32
+static const char *nullDevice = "NUL";
+#else
+#include <sys/wait.h>
+static const char *nullDevice = "/dev/null";
+#endif
+
+// Keeps the optimizer from dropping results we only compute for timing
+static volatile double sink;
+
+// Average getCTO latency over every CTO name, in nanoseconds
+double benchGetCTO(size_t ctoCount)
+{
+    CEO ceo("Bench CEO");
+    std::vector<std::string> names;
+    for (size_t i = 0; i < ctoCount; ++i)
+    {
+        names.push_back("CTO " + std::to_string(i));
+        ceo.addCTO(CTO(names.back(), "Field"));
+    }
+
+    const size_t lookups = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; ++i)
+    {
+        CTO *cto = ceo.getCTO(names[(i * 7919) % ctoCount]);
+        sink = sink + (cto != nullptr);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / lookups;
+}
+
+// Milliseconds taken by the fastest of a few runs of fn
+template <typename Fn>
+double bestMillis(Fn fn)
+{
+    double best = 1e300;
+    for (int run = 0; run < 5; ++run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+// Old array-of-structs team loop against the columnar kernels
+void benchAggregation(size_t memberCount)
+{
+    std::vector<TeamMember> rows;
+    std::vector<int> hours;
+    std::vector<double> contributions;
+    rows.reserve(memberCount);
+    hours.reserve(memberCount);
+    contributions.reserve(memberCount);
+    for (size_t i = 0; i < memberCount; ++i)
+    {
+        int h = 20 + static_cast<int>(i % 30);
+        double c = static_cast<double>(i % 1000) / 10;
+        rows.push_back(TeamMember("Member", "Developer", h, c));
+        hours.push_back(h);
+        contributions.push_back(c);
+    }
+
+    double rowLoop = bestMillis([&]
+                                {
+        double total = 0;
+        for (const auto &member : rows)
+        {
+            total += member.getContribution();
+        }
+        sink = total; });
+    double sumKernel = bestMillis([&]
+                                  { sink = sumContributions(contributions.data(), contributions.size()); });
+    double hoursKernel = bestMillis([&]
+                                    { sink = static_cast<double>(sumHours(hours.data(), hours.size())); });
+    double contributionKernel = bestMillis([&]
+                                           { sink = contributionStats(contributions.data(), contributions.size()).mean; });
+    double hoursStatsKernel = bestMillis([&]
+                                         { sink = hoursStats(hours.data(), hours.size()).mean; });
+
+    std::cout << "\nTeam aggregation over " << memberCount << " members (ms)\n";
+    std::cout << std::setw(35) << "row loop (old getTotalContribution)" << std::setw(12) << rowLoop << std::endl;
+    std::cout << std::setw(35) << "sumContributions" << std::setw(12) << sumKernel
+              << "  x" << rowLoop / sumKernel << std::endl;
+    std::cout << std::setw(35) << "sumHours" << std::setw(12) << hoursKernel << std::endl;
+    std::cout << std::setw(35) << "contributionStats" << std::setw(12) << contributionKernel << std::endl;
+    std::cout << std::setw(35) << "hoursStats" << std::setw(12) << hoursStatsKernel << std::endl;
+}
+
+// The display path before ReportWriter: one setw-formatted, flushed row at a time
+void legacyDisplay(std::ostream &out, const std::vector<TeamMember> &rows)
+{
+    out << "CTO: Bench CTO - Field: Field" << std::endl;
+    out << std::setw(15) << "Name"
+        << std::setw(20) << "Job"
+        << std::setw(10) << "Hours"
+        << std::setw(15) << "Contribution" << std::endl;
+    out << std::string(60, '-') << std::endl;
+    for (const auto &member : rows)
+    {
+        out << std::setw(15) << member.getName()
+            << std::setw(20) << member.getJob()
+            << std::setw(10) << member.getHours()
+            << std::setw(15) << member.getContribution() << std::endl;
+    }
+}
+
+// Renders a one-CTO org of rowCount members to the null device both ways
+void benchDisplay(size_t rowCount)
+{
+    CTO cto("Bench CTO", "Field");
+    std::vector<TeamMember> rows;
+    rows.reserve(rowCount);
+    for (size_t i = 0; i < rowCount; ++i)
+    {
+        rows.push_back(TeamMember("Member " + std::to_string(i), "Developer", 20 + static_cast<int>(i % 30),
+                                  static_cast<double>(i % 1000) / 10));
+        cto.addNewMember(rows.back());
+    }
+
+    std::ofstream out(nullDevice);
+    double legacy = bestMillis([&]
+                               { legacyDisplay(out, rows); });
+    double buffered = bestMillis([&]
+                                 {
+        ReportWriter report(out);
+        cto.writeReport(report); });
+
+    std::cout << "\nDisplaying " << rowCount << " rows to " << nullDevice << " (ms)\n";
+    std::cout << std::setw(35) << "setw + endl per row" << std::setw(12) << legacy << std::endl;
+    std::cout << std::setw(35) << "ReportWriter" << std::setw(12) << buffered
+              << "  x" << legacy / buffered << std::endl;
+}
+
+// An org of ctoCount CTOs sharing memberCount members round-robin
+void buildOrg(CEO &ceo, size_t ctoCount, size_t memberCount)
+{
+    std::vector<CTO *> ctos;
+    for (size_t i = 0; i < ctoCount; ++i)
+    {
+        ceo.addCTO(CTO("CTO " + std::to_string(i), "Field " + std::to_string(i % 7)));
+    }
+    for (size_t i = 0; i < ctoCount; ++i)
+    {
+        ctos.push_back(ceo.getCTO("CTO " + std::to_string(i)));
+    }
+    for (size_t i = 0; i < memberCount; ++i)
+    {
+        ctos[i % ctoCount]->addNewMember(TeamMember("Member " + std::to_string(i), "Job " + std::to_string(i % 50),
+                                                    static_cast<int>(i % 60), static_cast<double>(i % 997) / 4));
+    }
+}
+
+// The setup the org-wide benchmarks share: a CEO with ctoCount CTOs and
+// memberCount members dealt out by buildOrg, per-call timing, and the table
+// the results go in, one label and value per row
+struct OrgBench
+{
+    CEO ceo{"Bench CEO"};
+
+    OrgBench(size_t ctoCount, size_t memberCount)
+    {
+        buildOrg(ceo, ctoCount, memberCount);
+    }
+    // Nanoseconds per call over count calls of fn(i)
+    template <typename Fn>
+    static double nanosPerCall(size_t count, Fn fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i)
+        {
+            fn(i);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+    }
+    static void title(const std::string &text)
+    {
+        std::cout << "\n" << text << "\n";
+    }
+    static void row(const std::string &label, double value, const std::string &note = "")
+    {
+        std::cout << std::setw(35) << label << std::setw(12) << value << note << std::endl;
+    }
+};
+
+std::string renderOrg(const CEO &ceo)
+{
+    std::ostringstream out;
+    {
+        ReportWriter report(out);
+        ceo.writeReport(report);
+    }
+    return out.str();
+}
+
+// Times saving and loading a big org; false if either fails
+bool benchSnapshot(size_t memberCount)
+{
+    const std::string path = "benchmark_snapshot.bin";
+
+    CEO big("Bench CEO");
+    buildOrg(big, 500, memberCount);
+    auto start = std::chrono::steady_clock::now();
+    bool saved = big.saveSnapshot(path);
+    double saveMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    CEO loaded("Empty");
+    start = std::chrono::steady_clock::now();
+    bool ok = saved && loaded.loadSnapshot(path);
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::remove(path.c_str());
+
+    std::cout << "\nSnapshot of " << memberCount << " members: save " << saveMs << " ms, load " << loadMs << " ms"
+              << (ok ? "" : " (FAILED)") << std::endl;
+    return ok;
+}
+
+// Mutations per second with every record synced alone versus group commit
+void benchLog(size_t groupCommit, size_t mutations)
+{
+    const std::string path = "benchmark_wal.log";
+    std::remove(path.c_str());
+    double seconds;
+    {
+        CEO ceo("Bench CEO");
+        ceo.openLog(path, groupCommit);
+        ceo.addCTO(CTO("Bench CTO", "Field"));
+        CTO *cto = ceo.getCTO("Bench CTO");
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < mutations; ++i)
+        {
+            cto->addNewMember(TeamMember("Member " + std::to_string(i), "Developer", 40, 1.5));
+        }
+        ceo.commitLog();
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::remove(path.c_str());
+    std::cout << std::setw(20) << groupCommit << std::setw(15) << mutations / seconds << std::endl;
+}
+
+// Imports a generated CSV export with 1, 2, 4 and 8 threads
+void benchImport(size_t rowCount)
+{
+    const std::string path = "benchmark_import.csv";
+    {
+        std::ofstream csv(path);
+        csv << "cto,field,member,job,hours,contribution\n";
+        for (size_t i = 0; i < rowCount; ++i)
+        {
+            csv << "CTO " << i % 300 << ",Field " << i % 300 % 7 << ",Member " << i << ",Job " << i % 50 << ","
+                << i % 60 << "," << (i % 997) / 4.0 << "\n";
+        }
+    }
+
+    std::cout << "\nCSV import of " << rowCount << " rows\n";
+    std::cout << std::setw(10) << "threads" << std::setw(15) << "rows/s" << std::setw(15) << "same org" << std::endl;
+    std::string reference;
+    for (unsigned threads : {1u, 2u, 4u, 8u})
+    {
+        CEO ceo("Bench CEO");
+        ImportStats stats;
+        importCSV(ceo, path, threads, stats);
+        std::string rendered = renderOrg(ceo);
+        if (reference.empty())
+        {
+            reference = rendered;
+        }
+        std::cout << std::setw(10) << threads << std::setw(15) << stats.rows / stats.seconds
+                  << std::setw(15) << (rendered == reference ? "yes" : "NO") << std::endl;
+    }
+    std::remove(path.c_str());
+}
+
+// Resident set size of this process in bytes (Linux only, 0 elsewhere)
+size_t residentBytes()
+{
+    size_t pages = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    if (statm >> pages >> resident)
+    {
+#ifndef _WIN32
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+    return 0;
+}
+
+// Runs measure in a child process where possible, so memory freed by one
+// measurement cannot be reused by the next
+template <typename Fn>
+void isolated(Fn measure)
+{
+#ifndef _WIN32
+    std::cout.flush();
+    pid_t child = fork();
+    if (child == 0)
+    {
+#ifdef __GLIBC__
+        malloc_trim(0); // Hands pages freed by earlier benchmarks back, so reusing them shows up in RSS
+#endif
+        measure();
+        std::cout.flush();
+        _exit(0);
+    }
+    int status;
+    waitpid(child, &status, 0);
+#else
+    measure();
+#endif
+}
+
+// Resident memory of a team stored with one std::string job per member
+// against interned job IDs
+void benchInterning(size_t memberCount)
+{
+    static const char *titles[] = {"React Developer", "Vue.js Developer", "Node.js Developer", "Java Developer",
+                                   "Machine Learning Engineer", "Data Scientist", "AWS Specialist",
+                                   "Kubernetes Expert", "Azure Specialist", "GCP Engineer"};
+    auto report = [memberCount](const char *label, size_t before)
+    {
+        double perMember = static_cast<double>(residentBytes() - before) / memberCount;
+        std::cout << std::setw(30) << label << std::setw(10) << (residentBytes() - before) / (1024 * 1024)
+                  << std::setw(15) << perMember << std::endl;
+    };
+
+    std::cout << "\nResident memory for " << memberCount << " members\n";
+    std::cout << std::setw(30) << "layout" << std::setw(10) << "MiB" << std::setw(15) << "bytes/member" << std::endl;
+    isolated([&]
+             {
+        size_t before = residentBytes();
+        std::vector<std::string> names, jobs;
+        std::vector<int> hours;
+        std::vector<double> contributions;
+        names.reserve(memberCount);
+        jobs.reserve(memberCount);
+        hours.reserve(memberCount);
+        contributions.reserve(memberCount);
+        for (size_t i = 0; i < memberCount; ++i)
+        {
+            names.push_back("Member " + std::to_string(i));
+            jobs.push_back(titles[i % 10]);
+            hours.push_back(40);
+            contributions.push_back(1.5);
+        }
+        report("std::string job per member", before); });
+    isolated([&]
+             {
+        size_t before = residentBytes();
+        std::vector<int> hours(memberCount, 40);
+        std::vector<double> contributions(memberCount, 1.5);
+        CTO cto("Bench CTO", "Field");
+        cto.addNewMembers(
+            memberCount,
+            [](size_t i)
+            { return "Member " + std::to_string(i); },
+            [](size_t i)
+            { return std::string_view(titles[i % 10]); },
+            hours.data(), contributions.data());
+        hours = {};
+        contributions = {};
+        report("interned job IDs", before); });
+}
+
+// A team member as CTO::team stored it before the record layer: a
+// polymorphic Employee subclass held by value in a std::vector. Its virtual
+// destructor also suppresses the implicit move, so growing the vector copies.
+struct LegacyTeamMember
+{
+    LegacyTeamMember(std::string n, std::string j, int h, double c)
+        : name(std::move(n)), job(std::move(j)), hoursWorked(h), contribution(c) {}
+    virtual ~LegacyTeamMember() = default;
+    virtual void displayInfo() const {}
+    std::string name;
+    std::string job;
+    int hoursWorked;
+    double contribution;
+};
+
+// Growing a team one member at a time: std::vector<LegacyTeamMember>::push_back
+// against TeamStore::insert
+void benchTeamGrowth(size_t memberCount)
+{
+    std::cout << "\nGrowing a team to " << memberCount << " members\n";
+    std::cout << std::setw(30) << "storage" << std::setw(10) << "ms" << std::setw(15) << "bytes/member" << std::endl;
+    isolated([&]
+             {
+        size_t before = residentBytes();
+        auto start = std::chrono::steady_clock::now();
+        std::vector<LegacyTeamMember> team;
+        for (size_t i = 0; i < memberCount; ++i)
+        {
+            team.push_back(LegacyTeamMember("Member " + std::to_string(i), "Developer", 40, 1.5));
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::setw(30) << "vector<TeamMember> push_back" << std::setw(10) << ms << std::setw(15)
+                  << static_cast<double>(residentBytes() - before) / memberCount << std::endl; });
+    isolated([&]
+             {
+        size_t before = residentBytes();
+        auto start = std::chrono::steady_clock::now();
+        TeamStore team;
+        for (size_t i = 0; i < memberCount; ++i)
+        {
+            team.insert(TeamMember("Member " + std::to_string(i), "Developer", 40, 1.5));
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::setw(30) << "TeamStore insert" << std::setw(10) << ms << std::setw(15)
+                  << static_cast<double>(residentBytes() - before) / memberCount << std::endl; });
+}
+
+// CEO::aggregate on 1 to 32 threads against the serial per-CTO column stats.
+// Four CTOs hold half the members and 196 share the rest, so the big teams
+// get split and the small ones batched.
+void benchParallelAggregate(size_t memberCount)
+{
+    const size_t ctoCount = 200;
+    CEO ceo("Bench CEO");
+    std::vector<CTO *> ctos;
+    for (size_t i = 0; i < ctoCount; ++i)
+    {
+        ceo.addCTO(CTO("CTO " + std::to_string(i), "Field"));
+    }
+    for (size_t i = 0; i < ctoCount; ++i)
+    {
+        ctos.push_back(ceo.getCTO("CTO " + std::to_string(i)));
+    }
+    std::vector<int> hours(memberCount / ctoCount);
+    std::vector<double> contributions(hours.size());
+    for (size_t i = 0; i < ctoCount; ++i)
+    {
+        size_t count = i < 4 ? memberCount / 8 : memberCount / 2 / (ctoCount - 4);
+        hours.resize(count);
+        contributions.resize(count);
+        for (size_t m = 0; m < count; ++m)
+        {
+            hours[m] = static_cast<int>((m * 31 + i) % 60);
+            contributions[m] = static_cast<double>((m * 17 + i) % 997) / 4;
+        }
+        ctos[i]->addNewMembers(
+            count,
+            [](size_t)
+            { return std::string_view("Member"); },
+            [](size_t)
+            { return std::string_view("Developer"); },
+            hours.data(), contributions.data());
+    }
+
+    double serial = bestMillis([&]
+                               {
+        double total = 0;
+        for (const CTO *cto : ctos)
+        {
+            total += cto->getContributionStats().mean + cto->getHoursStats().mean + cto->getTotalHours();
+        }
+        sink = total; });
+    std::cout << "\nAggregating " << memberCount << " members in " << ctoCount << " CTOs (ms)\n";
+    std::cout << std::setw(20) << "serial column stats" << std::setw(12) << serial << std::endl;
+    std::cout << std::setw(20) << "threads" << std::setw(12) << "ms" << std::setw(12) << "speedup" << std::setw(12)
+              << "same" << std::endl;
+    double single = 0;
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u})
+    {
+        WorkStealingPool pool(threads);
+        OrgAggregate result;
+        double ms = bestMillis([&]
+                               { result = ceo.aggregate(pool); });
+        if (threads == 1)
+        {
+            single = ms;
+        }
+        bool same = result.org.count == memberCount / 8 * 4 + memberCount / 2 / (ctoCount - 4) * (ctoCount - 4);
+        for (size_t i = 0; i < ctoCount && same; ++i)
+        {
+            same = result.ctos[i].hoursSum == ctos[i]->getTotalHours() &&
+                   result.ctos[i].contribution().max == ctos[i]->getContributionStats().max &&
+                   result.ctos[i].hours().min == ctos[i]->getHoursStats().min;
+        }
+        std::cout << std::setw(20) << threads << std::setw(12) << ms << std::setw(12) << single / ms << std::setw(12)
+                  << (same ? "yes" : "NO") << std::endl;
+    }
+}
+
+// Org-wide top 100 contributors from the kept rankings against a partial
+// sort of every member's contribution, and what keeping the rankings costs a modify
+void benchTopMembers(size_t memberCount)
+{
+    OrgBench bench(300, memberCount);
+    CEO &ceo = bench.ceo;
+    const size_t k = 100;
+
+    std::vector<MemberRow> ranking;
+    double kept = bestMillis([&]
+                             { ranking = ceo.getTopMembers(k); });
+    // The same contributions buildOrg gave out, as a full scan would gather them
+    std::vector<std::pair<double, size_t>> contributions;
+    for (size_t i = 0; i < memberCount; ++i)
+    {
+        contributions.push_back({static_cast<double>(i % 997) / 4, i});
+    }
+    double scan = bestMillis([&]
+                             {
+        std::vector<std::pair<double, size_t>> all = contributions;
+        std::partial_sort(all.begin(), all.begin() + k, all.end(), RankOrder());
+        sink = all[0].first; });
+
+    CTO *cto = ceo.getCTO("CTO 0");
+    double perModify = OrgBench::nanosPerCall(200000, [&](size_t i)
+                                              {
+        size_t member = (i * 300) % memberCount;
+        cto->modifyTeamMember("Member " + std::to_string(member), "Job", 40, static_cast<double>((i * 7919) % 1000)); });
+
+    OrgBench::title("Top " + std::to_string(k) + " of " + std::to_string(memberCount) + " members in 300 CTOs");
+    OrgBench::row("kept rankings (ms)", kept);
+    OrgBench::row("sort every member (ms)", scan);
+    OrgBench::row("modify with ranking (ns)", perModify);
+}
+
+// Overtime (hours > 45) and low contributor (contribution < 1) audits through
+// the range indexes against a scan of every member
+void benchRangeQueries(size_t memberCount)
+{
+    OrgBench bench(300, memberCount);
+    CEO &ceo = bench.ceo;
+    // The rows buildOrg gave out, as a scan of every TeamMember sees them
+    std::vector<TeamMember> rows;
+    rows.reserve(memberCount);
+    for (size_t i = 0; i < memberCount; ++i)
+    {
+        rows.push_back(TeamMember("Member " + std::to_string(i), "Job " + std::to_string(i % 50), static_cast<int>(i % 60),
+                                  static_cast<double>(i % 997) / 4));
+    }
+    const double below = std::nextafter(1.0, 0.0);
+
+    auto start = std::chrono::steady_clock::now();
+    ceo.countByHours(0, 0); // Builds the indexes
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    size_t indexed = 0, scanned = 0;
+    double indexCount = bestMillis([&]
+                                   { indexed = ceo.countByHours(46, std::numeric_limits<int>::max()); });
+    double scanCount = bestMillis([&]
+                                  {
+        scanned = 0;
+        for (const auto &member : rows)
+        {
+            scanned += member.getHours() > 45;
+        }
+        sink = static_cast<double>(scanned); });
+    size_t listed = 0, scanListed = 0;
+    double indexList = bestMillis([&]
+                                  { listed = ceo.findByContribution(-std::numeric_limits<double>::infinity(), below).size(); });
+    double scanList = bestMillis([&]
+                                 {
+        std::vector<const TeamMember *> found;
+        for (const auto &member : rows)
+        {
+            if (member.getContribution() < 1)
+            {
+                found.push_back(&member);
+            }
+        }
+        scanListed = found.size(); });
+
+    CTO *cto = ceo.getCTO("CTO 0");
+    double perModify = OrgBench::nanosPerCall(200000, [&](size_t i)
+                                              {
+        size_t member = (i * 300) % memberCount;
+        cto->modifyTeamMember("Member " + std::to_string(member), "Job", static_cast<int>(i % 60),
+                              static_cast<double>((i * 7919) % 1000)); });
+
+    OrgBench::title("Range queries over " + std::to_string(memberCount) + " members (ms)");
+    OrgBench::row("build indexes", buildMs);
+    OrgBench::row("count hours > 45: index", indexCount, "  (" + std::to_string(indexed) + ")");
+    OrgBench::row("count hours > 45: scan", scanCount, "  (" + std::to_string(scanned) + ")");
+    OrgBench::row("list contribution < 1: index", indexList, "  (" + std::to_string(listed) + ")");
+    OrgBench::row("list contribution < 1: scan", scanList, "  (" + std::to_string(scanListed) + ")");
+    OrgBench::row("modify with indexes (ns)", perModify);
+}
+
+// One 50-row page from the middle of orgs of growing size against
+// displaying the whole org; a page should cost the same at every size
+void benchDisplayPage()
+{
+    std::cout << "\nOne page of 50 rows from the middle of the org (ms)\n";
+    std::cout << std::setw(10) << "members" << std::setw(15) << "whole org" << std::setw(15) << "storage page"
+              << std::setw(15) << "sorted page" << std::setw(15) << "team page" << std::endl;
+    std::ofstream out(nullDevice);
+    for (size_t memberCount : {10000, 100000, 1000000})
+    {
+        OrgBench bench(100, memberCount);
+        CEO &ceo = bench.ceo;
+        ceo.countByHours(0, 0); // Builds the indexes outside the timing
+        ceo.getCTO("CTO 50")->removeTeamMember("Member 50"); // Free slots send storage pages through nthMember
+        PageRequest storage;
+        storage.offset = memberCount / 2;
+        PageRequest sorted = storage;
+        sorted.order = PageRequest::Order::Contribution;
+        sorted.descending = true;
+        PageRequest team = sorted; // Sorted within one CTO, through its rank indexes
+        team.cto = "CTO 50";
+        team.offset = memberCount / 200;
+        {
+            ReportWriter report(out);
+            ceo.writePage(report, team); // Builds the CTO's rank indexes outside the timing
+        }
+
+        double whole = bestMillis([&]
+                                  {
+            ReportWriter report(out);
+            ceo.writeReport(report); });
+        double storagePage = bestMillis([&]
+                                        {
+            ReportWriter report(out);
+            ceo.writePage(report, storage); });
+        double sortedPage = bestMillis([&]
+                                       {
+            ReportWriter report(out);
+            ceo.writePage(report, sorted); });
+        double teamPage = bestMillis([&]
+                                     {
+            ReportWriter report(out);
+            ceo.writePage(report, team); });
+        std::cout << std::setw(10) << memberCount << std::setw(15) << whole << std::setw(15) << storagePage
+                  << std::setw(15) << sortedPage << std::setw(15) << teamPage << std::endl;
+    }
+}
+
+// Stress test for read snapshots: readers render the top CTO and the
+// org report from their latest snapshot while one writer keeps modifying
+// members, publishing after every edit. Each reader also checks that its snapshot's top
+// CTO really has the highest total, which a torn view would break.
+void benchConcurrentReads(size_t memberCount)
+{
+    const size_t ctoCount = 50;
+    std::cout << "\nConcurrent reads of a " << memberCount << "-member org with one writer\n";
+    std::cout << std::setw(10) << "readers" << std::setw(15) << "reports/s" << std::setw(15) << "publishes/s"
+              << std::setw(15) << "torn views" << std::endl;
+    for (size_t readerCount : {1, 2, 4, 8})
+    {
+        CEO ceo("Bench CEO");
+        buildOrg(ceo, ctoCount, memberCount);
+        ceo.publishSnapshot();
+
+        std::atomic<bool> stop{false};
+        std::atomic<size_t> reports{0}, torn{0};
+        std::vector<std::thread> readers;
+        for (size_t r = 0; r < readerCount; ++r)
+        {
+            readers.emplace_back([&]
+                                 {
+                std::unique_ptr<SnapshotReader> reader = ceo.openReader();
+                std::ostream discard(nullptr);
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const OrgSnapshot &org = reader->read();
+                    double best = 0;
+                    for (size_t i = 0; i < org.ctoCount(); ++i)
+                    {
+                        best = std::max(best, org.getCTO(i).getTotalContribution());
+                    }
+                    {
+                        ReportWriter report(discard);
+                        org.determineTopCTO(report);
+                        org.writeReport(report);
+                    }
+                    torn += org.getTopCTO()->getTotalContribution() != best;
+                    reader->done();
+                    ++reports;
+                } });
+        }
+
+        std::vector<CTO *> ctos;
+        for (size_t i = 0; i < ctoCount; ++i)
+        {
+            ctos.push_back(ceo.getCTO("CTO " + std::to_string(i)));
+        }
+        size_t publishes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t edit = 0; std::chrono::steady_clock::now() - start < std::chrono::seconds(1); ++edit)
+        {
+            size_t member = (edit * 7919) % memberCount;
+            ctos[member % ctoCount]->modifyTeamMember("Member " + std::to_string(member), "Job " + std::to_string(edit % 50),
+                                                      static_cast<int>(edit % 60), static_cast<double>(edit % 1013) / 4);
+            ceo.publishSnapshot(); // Copies just the one CTO edited
+            ++publishes;
+        }
+        stop = true;
+        for (auto &reader : readers)
+        {
+            reader.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::setw(10) << readerCount << std::setw(15) << reports / seconds << std::setw(15)
+                  << publishes / seconds << std::setw(15) << torn << std::endl;
+    }
+}
+
+// A 300-CTO org regrouped under 30 directors: director totals from the org
+// tree against re-summing their CTOs' teams, and what moving people costs
+void benchOrgTree(size_t memberCount)
+{
+    OrgBench bench(300, memberCount);
+    CEO &ceo = bench.ceo;
+    std::unique_ptr<OrgTree> tree;
+    double build = bestMillis([&]
+                              { tree = std::make_unique<OrgTree>(ceo); });
+
+    std::vector<OrgTree::Node> ctos, members, directors;
+    for (OrgTree::Node node = 1; node < tree->size(); ++node)
+    {
+        (tree->parentOf(node) == OrgTree::root ? ctos : members).push_back(node);
+    }
+    for (size_t i = 0; i < 30; ++i)
+    {
+        directors.push_back(tree->addManager(OrgTree::root, "Director " + std::to_string(i), "Director", "Field"));
+    }
+    for (size_t i = 0; i < ctos.size(); ++i)
+    {
+        tree->reparent(ctos[i], directors[i % directors.size()]);
+    }
+
+    // What a nested loop over each director's CTOs and their teams would add up
+    std::vector<std::vector<double>> teams(ctos.size());
+    for (size_t i = 0; i < memberCount; ++i)
+    {
+        teams[i % ctos.size()].push_back(static_cast<double>(i % 997) / 4);
+    }
+    double fromTree = bestMillis([&]
+                                 {
+        for (OrgTree::Node director : directors)
+        {
+            sink = sink + tree->subtreeTotals(director).contribution;
+        } });
+    double nested = bestMillis([&]
+                               {
+        for (size_t d = 0; d < directors.size(); ++d)
+        {
+            double total = 0;
+            for (size_t c = d; c < teams.size(); c += directors.size())
+            {
+                for (double contribution : teams[c])
+                {
+                    total += contribution;
+                }
+            }
+            sink = sink + total;
+        } });
+
+    const size_t moves = 100000;
+    double perMove = OrgBench::nanosPerCall(moves, [&](size_t i)
+                                            { tree->reparent(members[(i * 7919) % members.size()], ctos[i % ctos.size()]); });
+    double perModify = OrgBench::nanosPerCall(moves, [&](size_t i)
+                                              { tree->modifyMember(members[(i * 7919) % members.size()], "Job", 40,
+                                                                   static_cast<double>(i % 1000)); });
+
+    OrgBench::title("Org tree of " + std::to_string(memberCount) + " members, 300 CTOs under 30 directors");
+    OrgBench::row("build from CEO (ms)", build);
+    OrgBench::row("30 director totals (ms)", fromTree);
+    OrgBench::row("30 nested-loop re-sums (ms)", nested);
+    OrgBench::row("move a member to another CTO (ns)", perMove);
+    OrgBench::row("modify a member (ns)", perModify);
+}
+
+// Moving members between CTOs in batches against removing and re-adding them
+void benchTransfer(size_t memberCount)
+{
+    OrgBench bench(300, memberCount);
+    CEO &ceo = bench.ceo;
+    sink = sink + static_cast<double>(ceo.countByHours(0, 10)); // Builds the org-wide indexes the moves keep up
+
+    const size_t batches = 200, batchSize = 1000;
+    double batched = 0, oneByOne = 0;
+    for (size_t batch = 0; batch < batches; ++batch)
+    {
+        // Every batch moves a CTO's best members to the CTO 150 places on;
+        // the two ways take turns
+        bool asBatch = batch % 2 == 0;
+        CTOHandle from = ceo.findCTO("CTO " + std::to_string(batch % 300));
+        CTOHandle to = ceo.findCTO("CTO " + std::to_string((batch + 150) % 300));
+        std::vector<MemberRow> rows = ceo.getCTO(from)->getTopMembers(batchSize);
+        std::vector<MemberTransfer> moves;
+        for (const MemberRow &row : rows)
+        {
+            moves.push_back({from, row.handle, to});
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        if (asBatch)
+        {
+            ceo.transferMembers(moves);
+        }
+        else
+        {
+            for (const MemberRow &row : rows)
+            {
+                ceo.getCTO(from)->removeTeamMember(row.handle);
+                ceo.getCTO(to)->addNewMember(row.member);
+            }
+        }
+        double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        (asBatch ? batched : oneByOne) += elapsed;
+    }
+
+    size_t moved = batches / 2 * batchSize; // By each way
+    OrgBench::title("Moving " + std::to_string(moved) + " of " + std::to_string(memberCount) +
+                    " members each way between 300 CTOs");
+    OrgBench::row("transferMembers (ns/member)", batched / moved);
+    OrgBench::row("remove + add (ns/member)", oneByOne / moved);
+}
+
+// A made-up "First Last" name for member i, from a few hundred first names
+// and a few hundred thousand surnames, so some names repeat like real ones
+void personName(uint64_t i, std::string &name)
+{
+    static const char *syllables[] = {"an", "bel", "cor", "da", "el", "fin", "gar", "ha", "is", "jo",
+                                      "ka", "lin", "mar", "no", "or", "pe", "quin", "ro", "sa", "ta",
+                                      "ul", "va", "wen", "xi", "ya", "zo", "bri", "cla", "dre", "fro"};
+    const size_t count = sizeof(syllables) / sizeof(syllables[0]);
+    uint64_t h = (i + 1) * 0x9E3779B97F4A7C15ull;
+    h ^= h >> 29;
+    name.clear();
+    for (int part = 0; part < 2; ++part)
+    {
+        size_t length = part == 0 ? 2 : 2 + h % 2;
+        size_t start = name.size();
+        for (size_t s = 0; s < length; ++s, h /= count)
+        {
+            name += syllables[h % count];
+        }
+        name[start] = static_cast<char>(name[start] - 'a' + 'A');
+        if (part == 0)
+        {
+            name += ' ';
+        }
+    }
+}
+
+// Prefix completion and typo-tolerant lookups over every CTO and member name
+void benchNameSearch(size_t memberCount)
+{
+    const size_t ctoCount = 1000;
+    OrgBench bench(ctoCount, 0); // Members come below, with made-up names
+    CEO &ceo = bench.ceo;
+    std::vector<int> hours(memberCount / ctoCount, 40);
+    std::vector<double> contributions(hours.size(), 1);
+    std::string name;
+    for (size_t i = 0; i < ctoCount; ++i)
+    {
+        ceo.getCTO("CTO " + std::to_string(i))
+            ->addNewMembers(
+                hours.size(),
+                [&](size_t m)
+                {
+                    personName(i * hours.size() + m, name);
+                    return std::string_view(name);
+                },
+                [](size_t)
+                { return std::string_view("Developer"); },
+                hours.data(), contributions.data());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ceo.completeName("", 1); // Builds the index
+    double build = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Each query is a real name with a typo or two, or the start of one
+    const size_t queries = 2000;
+    uint64_t state = 42;
+    auto random = [&state]
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull; // Knuth's LCG
+        return state >> 33;
+    };
+    double completeTotal = 0, completeMax = 0, searchTotal = 0, searchMax = 0;
+    size_t found = 0;
+    for (size_t q = 0; q < queries; ++q)
+    {
+        personName(random() % memberCount, name);
+        std::string prefix = name.substr(0, 3 + random() % 5);
+        std::string typo = name;
+        for (size_t edits = 1 + q % 2; edits > 0; --edits)
+        {
+            size_t at = random() % (typo.size() - 1);
+            if (random() % 2)
+            {
+                std::swap(typo[at], typo[at + 1]);
+            }
+            else
+            {
+                typo[at] = static_cast<char>('a' + random() % 26);
+            }
+        }
+
+        start = std::chrono::steady_clock::now();
+        found += ceo.completeName(prefix, 10).size();
+        double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        completeTotal += elapsed;
+        completeMax = std::max(completeMax, elapsed);
+
+        start = std::chrono::steady_clock::now();
+        std::vector<NameMatch> matches = ceo.findSimilarNames(typo, 2, 10);
+        elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        found += !matches.empty() && matches.front().distance <= 2;
+        searchTotal += elapsed;
+        searchMax = std::max(searchMax, elapsed);
+    }
+    sink = sink + static_cast<double>(found);
+
+    OrgBench::title("Name search over " + std::to_string(memberCount + ctoCount) + " names");
+    OrgBench::row("build the index (ms)", build);
+    OrgBench::row("complete a prefix, k = 10 (us)", completeTotal / queries);
+    OrgBench::row("  slowest (us)", completeMax);
+    OrgBench::row("within 2 typos, k = 10 (us)", searchTotal / queries);
+    OrgBench::row("  slowest (us)", searchMax);
+}
+
+int main()
+{
+    std::cout << "CEO::getCTO lookup latency\n";
+    std::cout << std::setw(10) << "CTOs" << std::setw(15) << "ns/lookup" << std::endl;
+    for (size_t count : {10, 1000, 100000})
+    {
+        std::cout << std::setw(10) << count << std::setw(15) << benchGetCTO(count) << std::endl;
+    }
+    benchAggregation(10000000);
+    benchDisplay(1000000);
+    benchDisplayPage();
+    if (!benchSnapshot(5000000))
+    {
+        return 1; // A failed save or load leaves nothing worth timing; tests.cpp checks the round trip
+    }
+    std::cout << "\nWrite-ahead log mutations per second\n";
+    std::cout << std::setw(20) << "records per fsync" << std::setw(15) << "mutations/s" << std::endl;
+    benchLog(1, 2000);
+    benchLog(64, 200000);
+    benchLog(1024, 200000);
+    benchImport(5000000);
+    benchInterning(10000000);
+    benchTeamGrowth(10000000);
+    benchParallelAggregate(10000000);
+    benchTopMembers(3000000);
+    benchRangeQueries(3000000);
+    benchConcurrentReads(200000);
+    benchOrgTree(3000000);
+    benchTransfer(3000000);
+    benchNameSearch(10000000);
+    return 0;
+}
@@ -0,0 +1,427 @@
+// Micro-benchmarks of the core org operations on a synthetic org, printed as
+// JSON so runs against different versions can be diffed.
+// Build: g++ -std=c++17 -O2 -mavx2 -pthread -o microbench microbench.cpp
+//        g++ -std=c++17 -O2 -DEMS_VERSION=2 -o microbench2 microbench.cpp
+// Run:   ./microbench [--ctos N] [--members N] [--teams uniform|zipf] [--skew S]
+//                     [--jobs N] [--ops N] [--seed N] > version3.json
+#define EMS_NO_MAIN
+#ifndef EMS_VERSION
+#define EMS_VERSION 3
+#endif
+#if EMS_VERSION == 2
+#include "version2.cpp"
+#else
+#include "version3_no.cpp"
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <streambuf>
+
+// Same sequence on every platform and compiler, unlike the std distributions
+struct SplitMix64
+{
+    uint64_t state;
+
+    uint64_t next()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    size_t below(size_t bound)
+    {
+        return static_cast<size_t>(next() % bound);
+    }
+    template <typename T>
+    void shuffle(std::vector<T> &values)
+    {
+        for (size_t i = values.size(); i > 1; --i)
+        {
+            std::swap(values[i - 1], values[below(i)]);
+        }
+    }
+};
+
+struct OrgShape
+{
+    size_t ctoCount = 100;
+    size_t memberCount = 100000;
+    bool zipf = true;  // Team sizes follow 1/rank^skew, otherwise as even as possible
+    double skew = 1.0;
+    size_t jobCount = 50; // Distinct job titles
+    size_t ops = 20000;   // Operations per benchmark run
+    uint64_t seed = 42;
+};
+
+struct SyntheticMember
+{
+    size_t cto;
+    std::string name;
+    std::string job;
+    int hours;
+    double contribution;
+};
+
+// The same shape and seed always give the same org, member for member
+struct SyntheticOrg
+{
+    std::vector<std::string> ctoNames;
+    std::vector<std::string> fields;
+    std::vector<size_t> teamSizes;
+    std::vector<SyntheticMember> members; // In the order they are added
+
+    SyntheticOrg(const OrgShape &shape)
+    {
+        SplitMix64 random{shape.seed};
+        teamSizes.assign(shape.ctoCount, 0);
+        if (shape.zipf)
+        {
+            double total = 0;
+            for (size_t i = 0; i < shape.ctoCount; ++i)
+            {
+                total += 1 / std::pow(static_cast<double>(i + 1), shape.skew);
+            }
+            size_t assigned = 0;
+            for (size_t i = 0; i < shape.ctoCount; ++i)
+            {
+                double share = 1 / std::pow(static_cast<double>(i + 1), shape.skew) / total;
+                teamSizes[i] = static_cast<size_t>(static_cast<double>(shape.memberCount) * share);
+                assigned += teamSizes[i];
+            }
+            // Rounding leftovers go to the largest teams
+            for (size_t i = 0; assigned < shape.memberCount; ++i, ++assigned)
+            {
+                ++teamSizes[i % shape.ctoCount];
+            }
+            // Otherwise the biggest team would always be the first CTO added
+            random.shuffle(teamSizes);
+        }
+        else
+        {
+            for (size_t i = 0; i < shape.ctoCount; ++i)
+            {
+                teamSizes[i] = shape.memberCount / shape.ctoCount + (i < shape.memberCount % shape.ctoCount);
+            }
+        }
+
+        for (size_t i = 0; i < shape.ctoCount; ++i)
+        {
+            ctoNames.push_back("CTO " + std::to_string(i));
+            fields.push_back("Field " + std::to_string(i % 7));
+        }
+        members.reserve(shape.memberCount);
+        for (size_t cto = 0; cto < shape.ctoCount; ++cto)
+        {
+            for (size_t i = 0; i < teamSizes[cto]; ++i)
+            {
+                members.push_back({cto, "Member " + std::to_string(members.size()),
+                                   "Job " + std::to_string(random.below(shape.jobCount)),
+                                   static_cast<int>(1 + random.below(60)),
+                                   static_cast<double>(random.below(4000)) / 4});
+            }
+        }
+        // Teams grow interleaved, as they would through the menu
+        random.shuffle(members);
+    }
+};
+
+// The operations whose signatures differ between versions
+#if EMS_VERSION == 2
+static const char *versionName = "version2.cpp";
+
+TeamMember makeMember(const SyntheticMember &member)
+{
+    return TeamMember(member.name, member.job, member.hours);
+}
+void modifyMember(CTO &cto, const SyntheticMember &member)
+{
+    cto.modifyTeamMember(member.name, member.job, member.hours);
+}
+#else
+static const char *versionName = "version3_no.cpp";
+
+TeamMember makeMember(const SyntheticMember &member)
+{
+    return TeamMember(member.name, member.job, member.hours, member.contribution);
+}
+void modifyMember(CTO &cto, const SyntheticMember &member)
+{
+    cto.modifyTeamMember(member.name, member.job, member.hours, member.contribution);
+}
+#endif
+
+// Swallows everything written to it, so display benchmarks measure formatting
+// rather than the terminal
+class NullBuffer : public std::streambuf
+{
+protected:
+    int overflow(int c) override
+    {
+        return traits_type::not_eof(c);
+    }
+    std::streamsize xsputn(const char *, std::streamsize count) override
+    {
+        return count;
+    }
+};
+
+// Points std::cout at a NullBuffer for as long as it lives
+class SilenceCout
+{
+    NullBuffer nothing;
+    std::streambuf *previous;
+
+public:
+    SilenceCout() : previous(std::cout.rdbuf(&nothing)) {}
+    ~SilenceCout()
+    {
+        std::cout.rdbuf(previous);
+    }
+};
+
+// Keeps the optimizer from dropping results we only compute for timing
+static volatile double sink;
+
+// Adds the CTOs and returns them in SyntheticOrg order; members are left to the caller
+std::vector<CTO *> addCTOs(CEO &ceo, const SyntheticOrg &org)
+{
+    for (size_t i = 0; i < org.ctoNames.size(); ++i)
+    {
+        ceo.addCTO(CTO(org.ctoNames[i], org.fields[i]));
+    }
+    std::vector<CTO *> ctos;
+    for (const std::string &name : org.ctoNames)
+    {
+        ctos.push_back(ceo.getCTO(name));
+    }
+    return ctos;
+}
+
+void addMembers(const std::vector<CTO *> &ctos, const SyntheticOrg &org)
+{
+    for (const SyntheticMember &member : org.members)
+    {
+        ctos[member.cto]->addNewMember(makeMember(member));
+    }
+}
+
+// Nanoseconds taken by the fastest of a few runs of fn, each after an untimed setup
+template <typename Setup, typename Fn>
+double bestNanos(int runs, Setup setup, Fn fn)
+{
+    double best = 1e300;
+    for (int run = 0; run < runs; ++run)
+    {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    return best;
+}
+
+template <typename Fn>
+double bestNanos(int runs, Fn fn)
+{
+    return bestNanos(runs, [] {}, fn);
+}
+
+// One "name": {...} entry of the results object
+void printResult(const char *name, size_t ops, double nanos, bool last = false)
+{
+    std::cout << "    \"" << name << "\": {\"ops\": " << ops << ", \"ns_per_op\": " << nanos / static_cast<double>(ops)
+              << "}" << (last ? "\n" : ",\n");
+}
+
+void printUnsupported(const char *name)
+{
+    std::cout << "    \"" << name << "\": null,\n";
+}
+
+void runSuite(const OrgShape &shape)
+{
+    const int runs = 5;
+    SyntheticOrg org(shape);
+    SplitMix64 random{shape.seed ^ 0x5DEECE66Dull};
+
+    // A random member for each modify, with a fresh job, hours and contribution
+    std::vector<SyntheticMember> modifies;
+    for (size_t i = 0; i < shape.ops && !org.members.empty(); ++i)
+    {
+        SyntheticMember changed = org.members[random.below(org.members.size())];
+        changed.job = "Job " + std::to_string(random.below(shape.jobCount));
+        changed.hours = static_cast<int>(1 + random.below(60));
+        changed.contribution = static_cast<double>(random.below(4000)) / 4;
+        modifies.push_back(changed);
+    }
+    // Distinct members, since each can only be removed once
+    std::vector<size_t> removals(org.members.size());
+    for (size_t i = 0; i < removals.size(); ++i)
+    {
+        removals[i] = i;
+    }
+    random.shuffle(removals);
+    removals.resize(std::min(shape.ops, removals.size()));
+    std::vector<size_t> lookups;
+    for (size_t i = 0; i < shape.ops; ++i)
+    {
+        lookups.push_back(random.below(org.ctoNames.size()));
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "{\n  \"version\": \"" << versionName << "\",\n";
+    std::cout << "  \"org\": {\"ctos\": " << shape.ctoCount << ", \"members\": " << shape.memberCount
+              << ", \"teams\": \"" << (shape.zipf ? "zipf" : "uniform") << "\", \"skew\": " << shape.skew
+              << ", \"jobs\": " << shape.jobCount << ", \"seed\": " << shape.seed << ", \"largest_team\": "
+              << *std::max_element(org.teamSizes.begin(), org.teamSizes.end()) << "},\n";
+    std::cout << "  \"results\": {\n";
+
+    // addNewMember grows every team from empty
+    {
+        std::unique_ptr<CEO> ceo;
+        std::vector<CTO *> ctos;
+        double nanos = bestNanos(
+            runs, [&]
+            {
+                ceo.reset(); // Frees the previous org outside the timed region
+                ceo = std::make_unique<CEO>("Bench CEO");
+                ctos = addCTOs(*ceo, org); },
+            [&]
+            { addMembers(ctos, org); });
+        printResult("addNewMember", org.members.size(), nanos);
+    }
+
+    CEO ceo("Bench CEO");
+    std::vector<CTO *> ctos = addCTOs(ceo, org);
+    addMembers(ctos, org);
+
+    double nanos = bestNanos(runs, [&]
+                             {
+        for (size_t cto : lookups)
+        {
+            sink = sink + (ceo.getCTO(org.ctoNames[cto]) != nullptr);
+        } });
+    printResult("getCTO", lookups.size(), nanos);
+
+    nanos = bestNanos(runs, [&]
+                      {
+        for (const SyntheticMember &member : modifies)
+        {
+            modifyMember(*ctos[member.cto], member);
+        } });
+    printResult("modifyTeamMember", modifies.size(), nanos);
+
+#if EMS_VERSION == 2
+    printUnsupported("getTotalContribution");
+    printUnsupported("determineTopCTO");
+#else
+    nanos = bestNanos(runs, [&]
+                      {
+        for (size_t cto : lookups)
+        {
+            sink = sink + ctos[cto]->getTotalContribution();
+        } });
+    printResult("getTotalContribution", lookups.size(), nanos);
+
+    nanos = bestNanos(runs, [&]
+                      {
+        SilenceCout silence;
+        for (size_t i = 0; i < shape.ops; ++i)
+        {
+            ceo.determineTopCTO();
+        } });
+    printResult("determineTopCTO", shape.ops, nanos);
+#endif
+
+    nanos = bestNanos(runs, [&]
+                      {
+        SilenceCout silence;
+        ceo.displayInfo(); });
+    printResult("displayInfo", 1, nanos);
+    std::cout << "    \"displayInfo_per_member\": {\"ops\": " << org.members.size() << ", \"ns_per_op\": "
+              << nanos / static_cast<double>(std::max<size_t>(org.members.size(), 1)) << "},\n";
+
+    // Each run removes from a freshly built org
+    {
+        std::unique_ptr<CEO> fresh;
+        std::vector<CTO *> freshCTOs;
+        nanos = bestNanos(
+            runs, [&]
+            {
+                fresh.reset();
+                fresh = std::make_unique<CEO>("Bench CEO");
+                freshCTOs = addCTOs(*fresh, org);
+                addMembers(freshCTOs, org); },
+            [&]
+            {
+                for (size_t i : removals)
+                {
+                    freshCTOs[org.members[i].cto]->removeTeamMember(org.members[i].name);
+                } });
+        printResult("removeTeamMember", removals.size(), nanos, true);
+    }
+    std::cout << "  }\n}\n";
+}
+
+// Reads a whole number option value, rejecting trailing junk
+bool parseCount(const char *text, uint64_t &value)
+{
+    char *end;
+    value = std::strtoull(text, &end, 10);
+    return *text != '\0' && *text != '-' && *end == '\0';
+}
+
+int main(int argc, char *argv[])
+{
+    OrgShape shape;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        const char *value = i + 1 < argc ? argv[++i] : "";
+        size_t *count = option == "--ctos"      ? &shape.ctoCount
+                        : option == "--members" ? &shape.memberCount
+                        : option == "--jobs"    ? &shape.jobCount
+                        : option == "--ops"     ? &shape.ops
+                                                : nullptr;
+        bool valid = true;
+        if (count)
+        {
+            uint64_t number;
+            valid = parseCount(value, number) && number > 0;
+            *count = static_cast<size_t>(number);
+        }
+        else if (option == "--teams")
+        {
+            valid = std::strcmp(value, "zipf") == 0 || std::strcmp(value, "uniform") == 0;
+            shape.zipf = std::strcmp(value, "zipf") == 0;
+        }
+        else if (option == "--skew")
+        {
+            char *end;
+            shape.skew = std::strtod(value, &end);
+            valid = *value != '\0' && *end == '\0' && std::isfinite(shape.skew) && shape.skew >= 0;
+        }
+        else if (option == "--seed")
+        {
+            valid = parseCount(value, shape.seed);
+        }
+        else
+        {
+            valid = false;
+        }
+        if (!valid)
+        {
+            std::cerr << "Usage: " << argv[0] << " [--ctos N] [--members N] [--teams uniform|zipf] [--skew S]"
+                      << " [--jobs N] [--ops N] [--seed N]\n";
+            return 1;
+        }
+    }
+    runSuite(shape);
+    return 0;
+}
@@ -0,0 +1,1156 @@
+// Tests for the version3_no.cpp classes, each checked against a plain model
+// of what the org should hold.
+// Build: g++ -std=c++17 -O2 -pthread -o tests tests.cpp
+// Run:   ./tests   (prints every failed check and exits with 1 if there was one)
+#define EMS_NO_MAIN
+#include "version3_no.cpp"
+
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+
+static int failures = 0;
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+void check(bool ok, const char *what, int line)
+{
+    if (!ok)
+    {
+        std::cerr << "tests.cpp:" << line << ": failed: " << what << std::endl;
+        ++failures;
+    }
+}
+
+std::string renderOrg(const CEO &ceo)
+{
+    std::ostringstream out;
+    {
+        ReportWriter report(out);
+        ceo.writeReport(report);
+    }
+    return out.str();
+}
+
+std::string readFile(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string &path, const std::string &bytes)
+{
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+}
+
+// Members sharing a name: a lookup or modify by name takes the first of
+// them in slot order, the same one a snapshot load finds, while removing by
+// name takes all of them; handles pick out exactly one
+void testDuplicateNames()
+{
+    const std::string path = "tests_duplicates.snap";
+    CEO ceo("Test CEO");
+    CTO *cto = ceo.getCTO(ceo.addCTO(CTO("Alice", "Cloud")));
+    MemberHandle placeholder = cto->addNewMember(TeamMember("Xavier", "Developer", 40, 1));
+    MemberHandle first = cto->addNewMember(TeamMember("Sam", "Developer", 20, 2));
+    cto->removeTeamMember(placeholder);
+    MemberHandle reused = cto->addNewMember(TeamMember("Sam", "Tester", 30, 3)); // Takes the freed slot 0
+    MemberHandle third = cto->addNewMember(TeamMember("Sam", "Analyst", 10, 4));
+    CHECK(reused.slot < first.slot);
+    CHECK(cto->findMember("Sam").slot == reused.slot);
+
+    CHECK(ceo.saveSnapshot(path));
+    CEO loaded("Test CEO");
+    CHECK(loaded.loadSnapshot(path));
+    std::remove(path.c_str());
+    CHECK(cto->modifyTeamMember("Sam", "Manager", 45, 5));
+    CHECK(loaded.getCTO("Alice")->modifyTeamMember("Sam", "Manager", 45, 5));
+    CHECK(renderOrg(loaded) == renderOrg(ceo));
+    CHECK(cto->getTotalContribution() == 5 + 2 + 4);
+
+    // Removing by handle leaves the other two; the next lookup moves on to the first of them
+    CHECK(cto->removeTeamMember(reused));
+    CHECK(!cto->isValid(reused) && cto->isValid(first) && cto->isValid(third));
+    CHECK(cto->findMember("Sam").slot == first.slot);
+    CHECK(cto->modifyTeamMember("Sam", "Lead", 50, 6));
+    CHECK(cto->getTotalContribution() == 6 + 4);
+
+    CHECK(cto->removeTeamMember("Sam") == 2);
+    CHECK(!cto->isValid(first) && !cto->isValid(third));
+    CHECK(cto->findMember("Sam").slot == UINT32_MAX);
+    CHECK(!cto->modifyTeamMember("Sam", "Lead", 50, 6));
+    CHECK(cto->removeTeamMember("Sam") == 0);
+    CHECK(cto->getTotalContribution() == 0);
+}
+
+// Each CTO's running totals and the CEO's leaderboard against sums and a
+// sort recomputed from a model after every few adds, modifies and removes.
+// Contributions are quarters, so the sums are exact in any order.
+void testTotalsAndLeaderboard()
+{
+    std::mt19937 rng(3);
+    CEO ceo("Test CEO");
+    std::vector<CTOHandle> ctos;
+    std::vector<std::map<uint32_t, std::pair<MemberHandle, TeamMember>>> model(8); // Slot -> member, per CTO
+    for (size_t i = 0; i < model.size(); ++i)
+    {
+        ctos.push_back(ceo.addCTO(CTO("CTO" + std::to_string(i), "Field")));
+    }
+    for (size_t step = 0; step < 5000; ++step)
+    {
+        size_t c = rng() % ctos.size();
+        CTO *cto = ceo.getCTO(ctos[c]);
+        auto &team = model[c];
+        unsigned op = rng() % 6;
+        int hours = static_cast<int>(rng() % 60);
+        double contribution = static_cast<double>(rng() % 400) / 4;
+        if (op < 3 || team.empty())
+        {
+            TeamMember member("m" + std::to_string(step), "Job", hours, contribution);
+            MemberHandle handle = cto->addNewMember(member);
+            team.insert_or_assign(handle.slot, std::make_pair(handle, member));
+        }
+        else
+        {
+            auto it = std::next(team.begin(), rng() % team.size());
+            if (op == 3)
+            {
+                CHECK(cto->modifyTeamMember(it->second.second.getName(), "Job", hours, contribution));
+                it->second.second = TeamMember(it->second.second.getName(), "Job", hours, contribution);
+            }
+            else if (op == 4)
+            {
+                CHECK(cto->removeTeamMember(it->second.first));
+                team.erase(it);
+            }
+            else
+            {
+                CHECK(cto->removeTeamMember(it->second.second.getName()) == 1);
+                team.erase(it);
+            }
+        }
+        if (step % 25 != 0)
+        {
+            continue;
+        }
+
+        std::vector<std::pair<double, size_t>> ranking; // (total, position)
+        for (size_t i = 0; i < ctos.size(); ++i)
+        {
+            double total = 0;
+            long long totalHours = 0;
+            for (const auto &[slot, member] : model[i])
+            {
+                total += member.second.getContribution();
+                totalHours += member.second.getHours();
+            }
+            CHECK(ceo.getCTO(ctos[i])->getTotalContribution() == total);
+            CHECK(ceo.getCTO(ctos[i])->getTotalHours() == totalHours);
+            ranking.push_back({total, i});
+        }
+        std::sort(ranking.begin(), ranking.end(), RankOrder());
+        std::vector<const CTO *> top = ceo.getTopCTOs(3);
+        CHECK(top.size() == 3);
+        for (size_t i = 0; i < top.size(); ++i)
+        {
+            CHECK(top[i] == ceo.getCTO(ctos[ranking[i].second]));
+        }
+    }
+}
+
+// A snapshot load gives back the org that was saved: every CTO and member in
+// the same order, the same totals and ranking, and member indexes that work.
+// A damaged file is refused and leaves the org it was loaded into alone.
+void testSnapshotRoundTrip()
+{
+    const std::string path = "tests_round_trip.snap";
+    CEO ceo("Round Trip CEO");
+    for (size_t i = 0; i < 13; ++i)
+    {
+        CTO *cto = ceo.getCTO(ceo.addCTO(CTO("CTO" + std::to_string(i), "Field" + std::to_string(i % 3))));
+        std::vector<MemberHandle> members;
+        for (size_t m = 0; m < 40 + i; ++m)
+        {
+            members.push_back(cto->addNewMember(TeamMember("Member" + std::to_string(m % 30), "Job" + std::to_string(m % 4),
+                                                           static_cast<int>(m % 60), static_cast<double>(m * i % 97) / 4)));
+        }
+        for (size_t m = i; m < members.size(); m += 7)
+        {
+            cto->removeTeamMember(members[m]); // Leaves free slots behind
+        }
+    }
+    CHECK(ceo.saveSnapshot(path));
+    CEO loaded("Empty");
+    CHECK(loaded.loadSnapshot(path));
+    CHECK(renderOrg(loaded) == renderOrg(ceo));
+    std::vector<const CTO *> top = ceo.getTopCTOs(13), loadedTop = loaded.getTopCTOs(13);
+    CHECK(top.size() == 13 && loadedTop.size() == 13);
+    for (size_t i = 0; i < top.size() && i < loadedTop.size(); ++i)
+    {
+        CHECK(top[i]->getName() == loadedTop[i]->getName());
+        CHECK(top[i]->getTotalContribution() == loadedTop[i]->getTotalContribution());
+        CHECK(top[i]->getTotalHours() == loadedTop[i]->getTotalHours());
+    }
+    CHECK(loaded.countByHours(0, 30) == ceo.countByHours(0, 30));
+    CHECK(loaded.getCTO("CTO5")->modifyTeamMember("Member3", "Lead", 50, 25));
+    CHECK(ceo.getCTO("CTO5")->modifyTeamMember("Member3", "Lead", 50, 25));
+    CHECK(renderOrg(loaded) == renderOrg(ceo));
+
+    std::string bytes = readFile(path);
+    writeFile(path, bytes.substr(0, bytes.size() / 2));
+    CEO kept("Kept");
+    kept.addCTO(CTO("Alice", "Cloud"));
+    const std::string before = renderOrg(kept);
+    CHECK(!kept.loadSnapshot(path));
+    CHECK(renderOrg(kept) == before);
+    std::remove(path.c_str());
+}
+
+// A log cut short by a crash replays up to its last whole record and takes
+// new records after the cut. Two CTOs share a name, so replay has to go by
+// where each CTO is rather than by name.
+void testTornLogTail()
+{
+    const std::string path = "tests_wal.log";
+    std::remove(path.c_str());
+    std::string beforeLast, afterAll;
+    size_t beforeLastBytes;
+    {
+        CEO ceo("Test CEO");
+        CHECK(ceo.openLog(path, 1));
+        CTOHandle a = ceo.addCTO(CTO("Alice", "Cloud"));
+        CTOHandle b = ceo.addCTO(CTO("Alice", "Data"));
+        ceo.getCTO(a)->addNewMember(TeamMember("Xavier", "Developer", 40, 12.5));
+        ceo.getCTO(b)->addNewMember(TeamMember("Yara", "Tester", 35, 7));
+        ceo.getCTO(b)->modifyTeamMember("Yara", "Lead", 50, 9);
+        ceo.commitLog();
+        beforeLast = renderOrg(ceo);
+        beforeLastBytes = std::filesystem::file_size(path);
+
+        ceo.getCTO(b)->addNewMember(TeamMember("Wendy", "Manager", 45, 20));
+        ceo.commitLog();
+        afterAll = renderOrg(ceo);
+    }
+    const std::string full = readFile(path);
+
+    struct Case
+    {
+        std::string bytes;
+        const std::string &expected;
+        size_t repairedBytes;
+    };
+    const Case cases[] = {
+        {full, afterAll, full.size()},
+        {full + std::string("\x17\x00\x00", 3), afterAll, full.size()},   // Garbage after the last record
+        {full.substr(0, full.size() - 3), beforeLast, beforeLastBytes},      // Last record torn
+        {full.substr(0, beforeLastBytes + 5), beforeLast, beforeLastBytes}, // Only the start of the last record
+    };
+    for (const Case &c : cases)
+    {
+        writeFile(path, c.bytes);
+        CEO replayed("Test CEO");
+        CHECK(replayed.openLog(path, 1));
+        CHECK(renderOrg(replayed) == c.expected);
+        CHECK(std::filesystem::file_size(path) == c.repairedBytes);
+    }
+
+    // The log left by the last case takes new records where the last one was cut
+    std::string extended;
+    {
+        CEO ceo("Test CEO");
+        CHECK(ceo.openLog(path, 1));
+        ceo.getCTO(CTOHandle{1, ceo.findCTO("Alice").epoch})->addNewMember(TeamMember("Vera", "Developer", 30, 9));
+        ceo.commitLog();
+        extended = renderOrg(ceo);
+    }
+    CEO replayed("Test CEO");
+    CHECK(replayed.openLog(path, 1));
+    CHECK(renderOrg(replayed) == extended);
+    const CTOHandle second{1, replayed.findCTO("Alice").epoch};
+    CHECK(replayed.getCTO(second)->findMember("Vera").slot != UINT32_MAX);
+    CHECK(replayed.getCTO("Alice")->findMember("Vera").slot == UINT32_MAX);
+    std::remove(path.c_str());
+}
+
+// A handle to a removed member stops resolving, and keeps failing after its
+// slot goes to someone else: modify and remove through it touch nobody. A
+// CTO handle stops resolving once a snapshot load replaces the CTOs.
+void testStaleHandles()
+{
+    const std::string path = "tests_stale.snap";
+    CEO ceo("Test CEO");
+    CTOHandle a = ceo.addCTO(CTO("Alice", "Cloud"));
+    CTO *cto = ceo.getCTO(a);
+    MemberHandle keep = cto->addNewMember(TeamMember("Keep", "Developer", 10, 1));
+    std::vector<MemberHandle> stale;
+    MemberHandle current = cto->addNewMember(TeamMember("Gen0", "Developer", 20, 2));
+    for (int round = 1; round <= 5; ++round)
+    {
+        CHECK(cto->removeTeamMember(current));
+        CHECK(!cto->isValid(current));
+        stale.push_back(current);
+        current = cto->addNewMember(TeamMember("Gen" + std::to_string(round), "Developer", 20, 2));
+        CHECK(current.slot == stale.back().slot); // The freed slot is reused
+        CHECK(current.generation != stale.back().generation);
+        for (MemberHandle old : stale)
+        {
+            CHECK(!cto->isValid(old));
+            CHECK(!cto->modifyTeamMember(old, "Lead", 50, 40));
+            CHECK(!cto->removeTeamMember(old));
+        }
+        CHECK(cto->isValid(current) && cto->isValid(keep));
+        CHECK(cto->getTotalContribution() == 1 + 2);
+        CHECK(cto->getTotalHours() == 10 + 20);
+        CHECK(cto->findMember("Gen" + std::to_string(round)).slot == current.slot);
+    }
+
+    CHECK(ceo.saveSnapshot(path));
+    CHECK(ceo.loadSnapshot(path));
+    std::remove(path.c_str());
+    CHECK(ceo.getCTO(a) == nullptr);
+    CTOHandle reloaded = ceo.findCTO("Alice");
+    CHECK(reloaded.position == a.position && ceo.getCTO(reloaded) != nullptr);
+}
+
+// Each CTO's top members, and the CEO's merge of them, against a full sort
+// of a model after members are modified, removed and transferred. Teams grow
+// past the ranking's first capacity and then shrink, so it gets rebuilt.
+void testTopMembersMatchFullSort()
+{
+    std::mt19937 rng(15);
+    CEO ceo("Test CEO");
+    std::vector<CTOHandle> ctos;
+    std::vector<std::map<uint32_t, std::pair<MemberHandle, double>>> model(4); // Slot -> (handle, contribution), per CTO
+    for (size_t i = 0; i < model.size(); ++i)
+    {
+        ctos.push_back(ceo.addCTO(CTO("CTO" + std::to_string(i), "Field")));
+    }
+    auto randomMember = [&](std::map<uint32_t, std::pair<MemberHandle, double>> &team)
+    {
+        return std::next(team.begin(), rng() % team.size());
+    };
+    for (size_t step = 0; step < 3000; ++step)
+    {
+        size_t c = rng() % ctos.size();
+        CTO *cto = ceo.getCTO(ctos[c]);
+        auto &team = model[c];
+        unsigned op = rng() % 8;
+        double contribution = static_cast<double>(rng() % 40); // Few values, so ties are common
+        if ((step < 1200 && op < 6) || team.empty())
+        {
+            MemberHandle handle = cto->addNewMember(TeamMember("m" + std::to_string(step), "Job", 10, contribution));
+            team.insert_or_assign(handle.slot, std::make_pair(handle, contribution));
+        }
+        else if (op < 3)
+        {
+            auto it = randomMember(team);
+            CHECK(cto->modifyTeamMember(it->second.first, "Job", 10, contribution));
+            it->second.second = contribution;
+        }
+        else if (op < 6)
+        {
+            auto it = randomMember(team);
+            CHECK(cto->removeTeamMember(it->second.first));
+            team.erase(it);
+        }
+        else
+        {
+            size_t to = (c + 1 + rng() % (ctos.size() - 1)) % ctos.size();
+            auto it = randomMember(team);
+            std::vector<MemberHandle> moved;
+            CHECK(ceo.transferMembers({{ctos[c], it->second.first, ctos[to]}}, &moved));
+            CHECK(moved.size() == 1);
+            if (moved.size() == 1)
+            {
+                model[to].insert_or_assign(moved[0].slot, std::make_pair(moved[0], it->second.second));
+            }
+            team.erase(it);
+        }
+        if (step % 50 != 0)
+        {
+            continue;
+        }
+
+        std::vector<std::tuple<double, size_t, uint32_t>> everyone; // (-contribution, position, slot)
+        for (size_t i = 0; i < ctos.size(); ++i)
+        {
+            std::vector<std::pair<double, size_t>> sorted; // (contribution, slot)
+            for (const auto &[slot, member] : model[i])
+            {
+                sorted.push_back({member.second, slot});
+                everyone.push_back({-member.second, i, slot});
+            }
+            std::sort(sorted.begin(), sorted.end(), RankOrder());
+            for (size_t k : {size_t(1), size_t(10), sorted.size() + 2})
+            {
+                std::vector<MemberRow> top = ceo.getCTO(ctos[i])->getTopMembers(k);
+                CHECK(top.size() == std::min(k, sorted.size()));
+                for (size_t r = 0; r < top.size() && r < sorted.size(); ++r)
+                {
+                    CHECK(top[r].handle.slot == sorted[r].second);
+                    CHECK(top[r].member.getContribution() == sorted[r].first);
+                }
+            }
+        }
+        std::sort(everyone.begin(), everyone.end());
+        std::vector<MemberRow> top = ceo.getTopMembers(25);
+        CHECK(top.size() == std::min<size_t>(25, everyone.size()));
+        for (size_t r = 0; r < top.size() && r < everyone.size(); ++r)
+        {
+            CHECK(top[r].cto == ceo.getCTO(ctos[std::get<1>(everyone[r])]));
+            CHECK(top[r].handle.slot == std::get<2>(everyone[r]));
+        }
+    }
+}
+
+// Every page, in every order, for the whole org and for one CTO, against a
+// full sort of a model of the members. Members come and go and move between
+// CTOs, so teams have free slots and every index has been kept up, not rebuilt.
+void testPagesMatchFullSort()
+{
+    struct Member
+    {
+        std::string name;
+        int hours;
+        double contribution;
+    };
+    std::mt19937 rng(2024);
+    CEO ceo("Test CEO");
+    std::vector<CTOHandle> ctos;
+    for (size_t i = 0; i < 12; ++i)
+    {
+        ctos.push_back(ceo.addCTO(CTO("CTO" + std::to_string(i), "Field")));
+    }
+    std::map<std::pair<size_t, uint32_t>, Member> model; // (position, slot) -> member
+    std::vector<std::vector<MemberHandle>> handles(ctos.size());
+    size_t nextName = 0;
+
+    // The names on a page, in order: only member names start with 'm' and a digit
+    std::string page;
+    auto pageNames = [&](const PageRequest &request, size_t &total)
+    {
+        std::ostringstream out;
+        {
+            ReportWriter report(out);
+            total = ceo.writePage(report, request);
+        }
+        page = out.str();
+        std::istringstream in(page);
+        std::vector<std::string> names;
+        for (std::string token; in >> token;)
+        {
+            if (token.size() > 1 && token[0] == 'm' && std::isdigit(static_cast<unsigned char>(token[1])))
+            {
+                names.push_back(token);
+            }
+        }
+        return names;
+    };
+
+    for (size_t step = 0; step < 20000; ++step)
+    {
+        size_t c = rng() % ctos.size();
+        CTO *cto = ceo.getCTO(ctos[c]);
+        unsigned op = rng() % 10;
+        if (op < 5 || handles[c].empty())
+        {
+            Member member{"m" + std::to_string(nextName++), static_cast<int>(rng() % 60), static_cast<double>(rng() % 400) / 4};
+            MemberHandle handle = cto->addNewMember(TeamMember(member.name, "Job", member.hours, member.contribution));
+            handles[c].push_back(handle);
+            model[{c, handle.slot}] = member;
+        }
+        else
+        {
+            size_t k = rng() % handles[c].size();
+            MemberHandle handle = handles[c][k];
+            if (op < 7)
+            {
+                CHECK(cto->removeTeamMember(handle));
+                model.erase({c, handle.slot});
+                handles[c][k] = handles[c].back();
+                handles[c].pop_back();
+            }
+            else if (op < 9)
+            {
+                Member &member = model[{c, handle.slot}];
+                member.hours = static_cast<int>(rng() % 60);
+                member.contribution = static_cast<double>(rng() % 400) / 4;
+                CHECK(cto->modifyTeamMember(handle, "Job", member.hours, member.contribution));
+            }
+            else
+            {
+                size_t d = (c + 1 + rng() % (ctos.size() - 1)) % ctos.size();
+                std::vector<MemberHandle> moved;
+                CHECK(ceo.transferMembers({{ctos[c], handle, ctos[d]}}, &moved));
+                model[{d, moved[0].slot}] = model[{c, handle.slot}];
+                model.erase({c, handle.slot});
+                handles[d].push_back(moved[0]);
+                handles[c][k] = handles[c].back();
+                handles[c].pop_back();
+            }
+        }
+        if (step % 50 != 0)
+        {
+            continue;
+        }
+
+        PageRequest request;
+        request.order = static_cast<PageRequest::Order>(rng() % 3);
+        request.descending = rng() % 2 == 0;
+        request.pageSize = 1 + rng() % 60;
+        bool oneCTO = rng() % 2 == 0;
+        size_t position = rng() % ctos.size();
+        if (oneCTO)
+        {
+            request.cto = "CTO" + std::to_string(position);
+        }
+        std::vector<std::tuple<double, size_t, uint32_t, std::string>> expected; // (key, position, slot, name)
+        for (const auto &[where, member] : model)
+        {
+            if (oneCTO && where.first != position)
+            {
+                continue;
+            }
+            double key = request.order == PageRequest::Order::Hours          ? member.hours
+                         : request.order == PageRequest::Order::Contribution ? member.contribution
+                                                                             : 0;
+            expected.emplace_back(key, where.first, where.second, member.name);
+        }
+        std::sort(expected.begin(), expected.end());
+        if (request.descending && request.order != PageRequest::Order::Storage)
+        {
+            std::reverse(expected.begin(), expected.end());
+        }
+        request.offset = expected.empty() ? 0 : rng() % (expected.size() + 5);
+
+        size_t total = 0;
+        std::vector<std::string> names = pageNames(request, total);
+        CHECK(total == expected.size());
+        std::vector<std::string> wanted;
+        for (size_t row = request.offset; row < expected.size() && wanted.size() < request.pageSize; ++row)
+        {
+            wanted.push_back(std::get<3>(expected[row]));
+        }
+        CHECK(names == wanted);
+        const std::string rows = wanted.empty() ? "No rows on this page\n"
+                                                : "Rows " + std::to_string(request.offset + 1) + "-" + std::to_string(request.offset + wanted.size()) +
+                                                      " of " + std::to_string(expected.size()) + "\n";
+        CHECK(page.find(rows) != std::string::npos);
+    }
+}
+
+// The org-wide job index against a scan of a model, once it is built and
+// kept up while members change job titles, leave and move between CTOs
+void testJobIndexMatchesScan()
+{
+    std::mt19937 rng(16);
+    CEO ceo("Test CEO");
+    std::vector<CTOHandle> ctos;
+    std::vector<std::map<uint32_t, std::pair<MemberHandle, std::string>>> model(5); // Slot -> (handle, job), per CTO
+    const std::vector<std::string> jobs = {"Developer", "Tester", "Analyst", "Manager", "Designer"};
+    for (size_t i = 0; i < model.size(); ++i)
+    {
+        ctos.push_back(ceo.addCTO(CTO("CTO" + std::to_string(i), "Field")));
+    }
+    CHECK(ceo.findMembersWithJob("Developer").empty()); // Builds the index while the org is empty
+    for (size_t step = 0; step < 4000; ++step)
+    {
+        size_t c = rng() % ctos.size();
+        CTO *cto = ceo.getCTO(ctos[c]);
+        auto &team = model[c];
+        unsigned op = rng() % 6;
+        const std::string &job = jobs[step < 2000 ? rng() % jobs.size() : rng() % 2]; // Later on only two jobs are handed out
+        if (op < 2 || team.empty())
+        {
+            MemberHandle handle = cto->addNewMember(TeamMember("m" + std::to_string(step), job, 10, 1));
+            team.insert_or_assign(handle.slot, std::make_pair(handle, job));
+            continue;
+        }
+        auto it = std::next(team.begin(), rng() % team.size());
+        if (op < 4)
+        {
+            CHECK(cto->modifyTeamMember(it->second.first, job, 10, 1));
+            it->second.second = job;
+        }
+        else if (op == 4)
+        {
+            CHECK(cto->removeTeamMember(it->second.first));
+            team.erase(it);
+        }
+        else
+        {
+            size_t to = (c + 1 + rng() % (ctos.size() - 1)) % ctos.size();
+            std::vector<MemberHandle> moved;
+            CHECK(ceo.transferMembers({{ctos[c], it->second.first, ctos[to]}}, &moved));
+            if (moved.size() == 1)
+            {
+                model[to].insert_or_assign(moved[0].slot, std::make_pair(moved[0], it->second.second));
+            }
+            team.erase(it);
+        }
+        if (step % 100 != 0)
+        {
+            continue;
+        }
+
+        for (const std::string &wanted : jobs)
+        {
+            std::vector<std::pair<size_t, uint32_t>> expected; // (position, slot), in ctoList and slot order
+            std::vector<std::pair<const CTO *, size_t>> expectedCounts;
+            for (size_t i = 0; i < ctos.size(); ++i)
+            {
+                size_t count = 0;
+                for (const auto &[slot, member] : model[i])
+                {
+                    if (member.second == wanted)
+                    {
+                        expected.push_back({i, slot});
+                        ++count;
+                    }
+                }
+                CHECK(ceo.getCTO(ctos[i])->countMembersWithJob(wanted) == count);
+                if (count > 0)
+                {
+                    expectedCounts.push_back({ceo.getCTO(ctos[i]), count});
+                }
+            }
+            std::vector<MemberRow> rows = ceo.findMembersWithJob(wanted);
+            CHECK(rows.size() == expected.size());
+            for (size_t r = 0; r < rows.size() && r < expected.size(); ++r)
+            {
+                CHECK(rows[r].cto == ceo.getCTO(ctos[expected[r].first]));
+                CHECK(rows[r].handle.slot == expected[r].second);
+                CHECK(rows[r].member.getJob() == wanted);
+            }
+            CHECK(ceo.countMembersWithJob(wanted) == expectedCounts);
+        }
+        CHECK(ceo.findMembersWithJob("Astronaut").empty());
+        CHECK(ceo.countMembersWithJob("Astronaut").empty());
+    }
+}
+
+// RangeIndex's counts, range lists and ranked walks against a sorted model.
+// Blocks hold up to 1024 entries and are split or filled to 512, so the ranges
+// and ranks checked include those at block edges, and the entries come and go
+// until blocks split and empty out.
+void testRangeIndexMatchesScan()
+{
+    using Entry = RangeIndex<int>::Entry;
+    std::mt19937 rng(17);
+    RangeIndex<int> index;
+    std::vector<Entry> model; // Sorted
+    auto checkAgainstModel = [&]()
+    {
+        CHECK(index.size() == model.size());
+        std::vector<int> keys = {-5, 0, 1, 99, 100, 150, 1000};
+        for (size_t edge : {size_t(0), size_t(511), size_t(512), size_t(1023), size_t(1024), size_t(1535), model.size() - 1})
+        {
+            if (edge < model.size())
+            {
+                keys.push_back(model[edge].first);
+                keys.push_back(model[edge].first + 1);
+            }
+        }
+        for (int lo : keys)
+        {
+            for (int hi : keys)
+            {
+                std::vector<Entry> expected;
+                for (const Entry &entry : model)
+                {
+                    if (lo <= entry.first && entry.first <= hi)
+                    {
+                        expected.push_back(entry);
+                    }
+                }
+                std::vector<Entry> listed;
+                index.forEach(lo, hi, [&](const Entry &entry)
+                              { listed.push_back(entry); });
+                CHECK(index.count(lo, hi) == expected.size());
+                CHECK(listed == expected);
+            }
+        }
+        for (size_t rank : {size_t(0), size_t(1), size_t(511), size_t(512), size_t(1024), model.size() - 1, model.size(), model.size() + 3})
+        {
+            for (bool descending : {false, true})
+            {
+                std::vector<Entry> walked;
+                index.forEachFrom(rank, descending, [&](const Entry &entry)
+                                  {
+                    walked.push_back(entry);
+                    return walked.size() < 600; });
+                std::vector<Entry> expected;
+                for (size_t i = rank; i < model.size() && expected.size() < 600; ++i)
+                {
+                    expected.push_back(descending ? model[model.size() - 1 - i] : model[i]);
+                }
+                CHECK(walked == expected);
+            }
+        }
+    };
+    auto insert = [&](Entry entry)
+    {
+        index.insert(entry);
+        model.insert(std::lower_bound(model.begin(), model.end(), entry), entry);
+    };
+    auto erase = [&](size_t at)
+    {
+        index.erase(model[at]);
+        model.erase(model.begin() + at);
+    };
+
+    checkAgainstModel(); // Empty
+    uint64_t id = 0;
+    for (size_t i = 0; i < 3000; ++i)
+    {
+        model.push_back({static_cast<int>(rng() % 100), id++});
+    }
+    index.assign(model);
+    std::sort(model.begin(), model.end());
+    checkAgainstModel();
+
+    // Inserts bunched into a few keys split the blocks holding them
+    for (size_t i = 0; i < 2500; ++i)
+    {
+        insert({static_cast<int>(40 + rng() % 3), id++});
+    }
+    checkAgainstModel();
+    index.erase({40, UINT64_MAX}); // Not there: no change
+    index.erase({1000, 0});
+    checkAgainstModel();
+
+    // Emptying a key range removes whole blocks
+    while (!model.empty() && model.back().first >= 30)
+    {
+        erase(model.size() - 1);
+    }
+    checkAgainstModel();
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        if (rng() % 3 == 0 && !model.empty())
+        {
+            erase(rng() % model.size());
+        }
+        else
+        {
+            insert({static_cast<int>(rng() % 150), id++});
+        }
+    }
+    checkAgainstModel();
+    while (!model.empty())
+    {
+        erase(rng() % model.size());
+    }
+    checkAgainstModel();
+    insert({7, id++}); // Starts over from no blocks
+    checkAgainstModel();
+}
+
+// OrgTree's subtree totals and top subtrees against sums over a plain model
+// of the tree, while people are added, modified, removed and moved under new
+// managers. A tree built from a CEO renders just as the CEO does.
+void testOrgTreeMatchesNestedSums()
+{
+    struct Person
+    {
+        OrgTree::Node parent;
+        bool manager;
+        bool removed;
+        int hours;
+        double contribution;
+        std::vector<OrgTree::Node> children; // In order
+    };
+    std::mt19937 rng(23);
+    CEO ceo("Tree CEO");
+    for (size_t i = 0; i < 3; ++i)
+    {
+        CTO *cto = ceo.getCTO(ceo.addCTO(CTO("CTO" + std::to_string(i), "Field")));
+        for (size_t m = 0; m < 5; ++m)
+        {
+            cto->addNewMember(TeamMember("m" + std::to_string(m), "Job", static_cast<int>(m), static_cast<double>(m) / 4));
+        }
+    }
+    OrgTree tree(ceo);
+    CHECK(tree.size() == 1 + 3 * 6);
+    std::ostringstream treeOut;
+    {
+        ReportWriter report(treeOut);
+        tree.writeReport(report);
+    }
+    CHECK(treeOut.str() == renderOrg(ceo));
+
+    std::vector<Person> model(tree.size());
+    model[OrgTree::root] = {OrgTree::none, true, false, 0, 0, {}};
+    for (OrgTree::Node node = 1; node < tree.size(); ++node)
+    {
+        OrgTree::Node parent = tree.parentOf(node);
+        bool manager = parent == OrgTree::root;
+        int hours = manager ? 0 : static_cast<int>((node - parent - 1) % 5);
+        model[node] = {parent, manager, false, hours, static_cast<double>(hours) / 4, {}};
+        model[parent].children.push_back(node);
+    }
+    auto pick = [&](bool wantManager)
+    {
+        while (true)
+        {
+            OrgTree::Node node = static_cast<OrgTree::Node>(rng() % model.size());
+            if (!model[node].removed && model[node].manager == wantManager)
+            {
+                return node;
+            }
+        }
+    };
+    auto inside = [&](OrgTree::Node node, OrgTree::Node top)
+    {
+        for (; node != OrgTree::none; node = model[node].parent)
+        {
+            if (node == top)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+    auto unlink = [&](OrgTree::Node node)
+    {
+        std::vector<OrgTree::Node> &siblings = model[model[node].parent].children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), node));
+    };
+
+    for (size_t step = 0; step < 4000; ++step)
+    {
+        unsigned op = rng() % 10;
+        int hours = static_cast<int>(rng() % 60);
+        double contribution = static_cast<double>(rng() % 400) / 4;
+        if (op < 2)
+        {
+            OrgTree::Node parent = pick(true);
+            OrgTree::Node node = tree.addManager(parent, "Lead" + std::to_string(step), "Lead", "Field");
+            CHECK(node == model.size());
+            model.push_back({parent, true, false, 0, 0, {}});
+            model[parent].children.push_back(node);
+        }
+        else if (op < 5)
+        {
+            OrgTree::Node parent = pick(true);
+            OrgTree::Node node = tree.addMember(parent, "m" + std::to_string(step), "Job", hours, contribution);
+            CHECK(node == model.size());
+            model.push_back({parent, false, false, hours, contribution, {}});
+            model[parent].children.push_back(node);
+            CHECK(tree.addMember(node, "Nobody", "Job", 1, 1) == OrgTree::none); // Members have no reports
+        }
+        else if (op < 7)
+        {
+            OrgTree::Node member = pick(false);
+            CHECK(tree.modifyMember(member, "Job", hours, contribution));
+            model[member].hours = hours;
+            model[member].contribution = contribution;
+            CHECK(!tree.modifyMember(pick(true), "Job", hours, contribution));
+        }
+        else if (op < 9)
+        {
+            OrgTree::Node node = rng() % 4 == 0 ? pick(true) : pick(false), parent = pick(true);
+            bool allowed = node != OrgTree::root && !inside(parent, node);
+            CHECK(tree.reparent(node, parent) == allowed);
+            if (allowed)
+            {
+                unlink(node);
+                model[node].parent = parent;
+                model[parent].children.push_back(node);
+            }
+        }
+        else
+        {
+            OrgTree::Node member = pick(false);
+            CHECK(tree.removeMember(member));
+            CHECK(!tree.removeMember(member));
+            CHECK(!tree.modifyMember(member, "Job", hours, contribution));
+            CHECK(!tree.reparent(member, OrgTree::root));
+            CHECK(tree.parentOf(member) == OrgTree::none);
+            unlink(member);
+            model[member].removed = true;
+        }
+        if (step % 50 != 0)
+        {
+            continue;
+        }
+
+        // Reparenting can leave a child numbered below its parent, so the
+        // sums come from a post-order walk rather than one pass by number
+        std::vector<SubtreeTotals> expected(model.size());
+        std::vector<std::pair<OrgTree::Node, bool>> pending{{OrgTree::root, false}};
+        while (!pending.empty())
+        {
+            auto [node, childrenDone] = pending.back();
+            pending.pop_back();
+            if (!childrenDone)
+            {
+                pending.push_back({node, true});
+                for (OrgTree::Node child : model[node].children)
+                {
+                    pending.push_back({child, false});
+                }
+                continue;
+            }
+            SubtreeTotals &totals = expected[node];
+            totals = {1, model[node].hours, model[node].contribution};
+            for (OrgTree::Node child : model[node].children)
+            {
+                totals.people += expected[child].people;
+                totals.hours += expected[child].hours;
+                totals.contribution += expected[child].contribution;
+            }
+        }
+        for (OrgTree::Node node = 0; node < model.size(); ++node)
+        {
+            SubtreeTotals totals = tree.subtreeTotals(node);
+            const Person &person = model[node];
+            if (person.removed)
+            {
+                CHECK(totals.people == 0);
+                CHECK(tree.topSubtree(node) == OrgTree::none);
+                continue;
+            }
+            CHECK(tree.parentOf(node) == person.parent);
+            CHECK(totals.people == expected[node].people);
+            CHECK(totals.hours == expected[node].hours);
+            CHECK(totals.contribution == expected[node].contribution);
+            OrgTree::Node best = OrgTree::none;
+            for (OrgTree::Node child : person.children)
+            {
+                if (best == OrgTree::none || expected[child].contribution > expected[best].contribution)
+                {
+                    best = child;
+                }
+            }
+            CHECK(tree.topSubtree(node) == best);
+        }
+    }
+}
+
+// A transfer batch is logged as a unit: a log cut anywhere inside it replays
+// without any of its moves, and one cut after it replays all of them
+void testTornTransferBatch()
+{
+    const std::string path = "tests_batch.log";
+    std::remove(path.c_str());
+    std::string beforeBatch, afterBatch;
+    size_t beforeBatchBytes, afterBatchBytes;
+    {
+        CEO ceo("Test CEO");
+        CHECK(ceo.openLog(path, 1));
+        CTOHandle a = ceo.addCTO(CTO("Alice", "Cloud"));
+        CTOHandle b = ceo.addCTO(CTO("Bob", "Data"));
+        MemberHandle x = ceo.getCTO(a)->addNewMember(TeamMember("Xavier", "Developer", 40, 12.5));
+        MemberHandle y = ceo.getCTO(a)->addNewMember(TeamMember("Yara", "Tester", 35, 7));
+        ceo.getCTO(b)->addNewMember(TeamMember("Zed", "Analyst", 20, 3));
+        ceo.commitLog();
+        beforeBatch = renderOrg(ceo);
+        beforeBatchBytes = std::filesystem::file_size(path);
+
+        CHECK(ceo.transferMembers({{a, x, b}, {a, y, b}}));
+        ceo.commitLog();
+        afterBatch = renderOrg(ceo);
+        afterBatchBytes = std::filesystem::file_size(path);
+    }
+    const std::string full = readFile(path);
+    for (size_t cut = beforeBatchBytes; cut <= afterBatchBytes; ++cut)
+    {
+        writeFile(path, full.substr(0, cut));
+        CEO replayed("Test CEO");
+        CHECK(replayed.openLog(path, 1));
+        CHECK(renderOrg(replayed) == (cut == afterBatchBytes ? afterBatch : beforeBatch));
+        CHECK(std::filesystem::file_size(path) == (cut == afterBatchBytes ? afterBatchBytes : beforeBatchBytes));
+        CHECK(replayed.getCTO("Bob")->getTotalContribution() == (cut == afterBatchBytes ? 22.5 : 3));
+    }
+    std::remove(path.c_str());
+}
+
+// A transfer batch with any bad move is turned down whole: no member moves,
+// no total changes and nothing reaches the log
+void testRejectedTransfer()
+{
+    const std::string path = "tests_transfer.log";
+    std::remove(path.c_str());
+    CEO ceo("Test CEO");
+    CHECK(ceo.openLog(path, 1));
+    CTOHandle a = ceo.addCTO(CTO("Alice", "Cloud"));
+    CTOHandle b = ceo.addCTO(CTO("Bob", "Data"));
+    MemberHandle x = ceo.getCTO(a)->addNewMember(TeamMember("Xavier", "Developer", 40, 12.5));
+    MemberHandle gone = ceo.getCTO(a)->addNewMember(TeamMember("Yara", "Tester", 35, 7));
+    MemberHandle z = ceo.getCTO(b)->addNewMember(TeamMember("Zed", "Analyst", 20, 3));
+    ceo.getCTO(a)->removeTeamMember(gone);
+    ceo.commitLog();
+    const std::string before = renderOrg(ceo);
+    const size_t logBytes = std::filesystem::file_size(path);
+    const double totalA = ceo.getCTO(a)->getTotalContribution(), totalB = ceo.getCTO(b)->getTotalContribution();
+
+    const std::vector<MemberTransfer> rejected[] = {
+        {{a, x, b}, {a, gone, b}},           // A removed member
+        {{a, x, b}, {a, x, b}},              // The same member twice
+        {{a, x, b}, {b, z, b}},              // A move within one CTO
+        {{a, x, b}, {b, z, CTOHandle()}},    // No such CTO
+        {{a, x, b}, {b, MemberHandle(), a}}, // A handle that never named anyone
+    };
+    for (const std::vector<MemberTransfer> &moves : rejected)
+    {
+        std::vector<MemberHandle> moved;
+        CHECK(!ceo.transferMembers(moves, &moved));
+        CHECK(moved.empty());
+        ceo.commitLog();
+        CHECK(renderOrg(ceo) == before);
+        CHECK(std::filesystem::file_size(path) == logBytes);
+        CHECK(ceo.getCTO(a)->getTotalContribution() == totalA);
+        CHECK(ceo.getCTO(b)->getTotalContribution() == totalB);
+        CHECK(ceo.getCTO(a)->isValid(x) && ceo.getCTO(b)->isValid(z));
+    }
+
+    CHECK(ceo.transferMembers({{a, x, b}}));
+    CHECK(ceo.getCTO(a)->getTotalContribution() == 0);
+    CHECK(ceo.getCTO(b)->getTotalContribution() == totalA + totalB);
+    std::remove(path.c_str());
+}
+
+// Edit distance with adjacent swaps (optimal string alignment), the plain way
+uint32_t editDistance(const std::string &a, const std::string &b)
+{
+    std::vector<std::vector<uint32_t>> d(a.size() + 1, std::vector<uint32_t>(b.size() + 1));
+    for (size_t i = 0; i <= a.size(); ++i)
+    {
+        d[i][0] = static_cast<uint32_t>(i);
+    }
+    for (size_t j = 0; j <= b.size(); ++j)
+    {
+        d[0][j] = static_cast<uint32_t>(j);
+    }
+    for (size_t i = 1; i <= a.size(); ++i)
+    {
+        for (size_t j = 1; j <= b.size(); ++j)
+        {
+            d[i][j] = std::min({d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + (a[i - 1] != b[j - 1])});
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+            {
+                d[i][j] = std::min(d[i][j], d[i - 2][j - 2] + 1);
+            }
+        }
+    }
+    return d[a.size()][b.size()];
+}
+
+std::string lowered(std::string text)
+{
+    for (char &c : text)
+    {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return text;
+}
+
+// NameIndex::similar and complete against a scan of every name, over names
+// from small alphabets so that near misses and repeats are common
+void testNameSearchMatchesScan()
+{
+    std::mt19937 rng(99);
+    for (int round = 0; round < 60; ++round)
+    {
+        const std::string alphabet = round % 2 ? "abAB" : "abcdeXY ";
+        auto randomName = [&]
+        {
+            std::string name;
+            for (size_t length = rng() % 9; length > 0; --length)
+            {
+                name += alphabet[rng() % alphabet.size()];
+            }
+            return name;
+        };
+        NameIndex index;
+        std::multimap<std::string, uint64_t> model;
+        uint64_t nextId = 0;
+        for (int step = 0; step < 300; ++step)
+        {
+            if (rng() % 3 != 0 || model.empty())
+            {
+                std::string name = randomName();
+                index.insert(name, nextId);
+                model.emplace(name, nextId++);
+            }
+            else
+            {
+                auto it = std::next(model.begin(), rng() % model.size());
+                CHECK(index.erase(it->first, it->second));
+                model.erase(it);
+            }
+            if (step == 150 && round % 3 == 0)
+            {
+                index.assign(std::vector<std::pair<std::string, uint64_t>>(model.begin(), model.end()));
+            }
+        }
+        CHECK(index.size() == model.size());
+
+        for (int query = 0; query < 30; ++query)
+        {
+            std::string name = randomName(), folded = lowered(name);
+            size_t k = 1 + rng() % 12;
+            uint32_t maxDistance = rng() % 4;
+
+            // Fewest edits, then closest in length, then alphabetical
+            std::vector<std::tuple<uint32_t, size_t, std::string, uint64_t>> near;
+            // Shortest, then alphabetical
+            std::vector<std::tuple<size_t, std::string, uint64_t>> starting;
+            for (const auto &[key, id] : model)
+            {
+                std::string candidate = lowered(key);
+                uint32_t distance = editDistance(folded, candidate);
+                if (distance <= maxDistance)
+                {
+                    size_t lengthGap = candidate.size() > folded.size() ? candidate.size() - folded.size() : folded.size() - candidate.size();
+                    near.emplace_back(distance, lengthGap, candidate, id);
+                }
+                if (candidate.compare(0, folded.size(), folded) == 0)
+                {
+                    starting.emplace_back(candidate.size(), candidate, id);
+                }
+            }
+            std::sort(near.begin(), near.end());
+            std::sort(starting.begin(), starting.end());
+
+            std::vector<NameIndex::Match> similar = index.similar(name, maxDistance, k);
+            CHECK(similar.size() == std::min(k, near.size()));
+            for (size_t i = 0; i < similar.size() && i < near.size(); ++i)
+            {
+                CHECK(similar[i].id == std::get<3>(near[i]) && similar[i].distance == std::get<0>(near[i]));
+            }
+            std::vector<NameIndex::Match> completions = index.complete(name, k);
+            CHECK(completions.size() == std::min(k, starting.size()));
+            for (size_t i = 0; i < completions.size() && i < starting.size(); ++i)
+            {
+                CHECK(completions[i].id == std::get<2>(starting[i]));
+            }
+        }
+    }
+}
+
+int main()
+{
+    testDuplicateNames();
+    testTotalsAndLeaderboard();
+    testSnapshotRoundTrip();
+    testTornLogTail();
+    testStaleHandles();
+    testTopMembersMatchFullSort();
+    testPagesMatchFullSort();
+    testJobIndexMatchesScan();
+    testRangeIndexMatchesScan();
+    testOrgTreeMatchesNestedSums();
+    testTornTransferBatch();
+    testRejectedTransfer();
+    testNameSearchMatchesScan();
+    if (failures > 0)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All tests passed" << std::endl;
+    return 0;
+}
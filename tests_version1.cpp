@@ -0,0 +1,327 @@
+// Tests for the version1.cpp JobSystem: runs against the order its
+// dependencies demand, and its indexes against a plain scan of the jobs.
+// Build: g++ -std=c++17 -O2 -pthread -o tests_version1 tests_version1.cpp
+// Run:   ./tests_version1   (prints every failed check and exits with 1 if there was one)
+#define EMS_NO_MAIN
+#include "version1.cpp"
+
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+static int failures = 0;
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+void check(bool ok, const char *what, int line)
+{
+    if (!ok)
+    {
+        std::cerr << "tests_version1.cpp:" << line << ": failed: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// The status displayJobs shows for each job, in job order
+std::vector<std::string> shownStatuses(const JobSystem &jobSystem)
+{
+    std::ostringstream out;
+    std::streambuf *saved = std::cout.rdbuf(out.rdbuf());
+    jobSystem.displayJobs();
+    std::cout.rdbuf(saved);
+    std::istringstream in(out.str());
+    std::vector<std::string> statuses;
+    for (std::string line; std::getline(in, line);)
+    {
+        size_t open = line.find('['), close = line.find(']');
+        if (open != std::string::npos && close != std::string::npos)
+        {
+            statuses.push_back(line.substr(open + 1, close - open - 1));
+        }
+    }
+    return statuses;
+}
+
+size_t jobsRun(const JobSystem::RunStats &stats)
+{
+    size_t total = 0;
+    for (const JobSystem::WorkerStats &worker : stats.workers)
+    {
+        total += worker.jobsRun;
+    }
+    return total;
+}
+
+// A chain and a diamond, next to independent jobs, always run each job after
+// everything it depends on, on any number of workers
+void testDependencyOrder()
+{
+    for (unsigned threads : {1u, 2u, 4u, 8u})
+    {
+        for (int round = 0; round < 25; ++round)
+        {
+            JobSystem jobSystem;
+            std::atomic<int> clock{0};
+            std::vector<int> ranAt(64, -1); // Each slot is written by one task only
+            auto task = [&](size_t job)
+            {
+                return [&, job]
+                { ranAt[job] = clock++; };
+            };
+            jobSystem.addJob("Done by hand", true);
+            size_t chain[4];
+            for (size_t i = 0; i < 4; ++i)
+            {
+                chain[i] = jobSystem.addTask("Chain", static_cast<int>(i), task(1 + i),
+                                             i == 0 ? std::vector<size_t>{0} : std::vector<size_t>{chain[i - 1]});
+            }
+            size_t top = jobSystem.addTask("Top", 1, task(5));
+            size_t left = jobSystem.addTask("Left", 2, task(6), {top});
+            size_t right = jobSystem.addTask("Right", 3, task(7), {top});
+            size_t bottom = jobSystem.addTask("Bottom", 0, task(8), {left, right});
+            for (size_t i = 9; i < 40; ++i)
+            {
+                jobSystem.addTask("Independent", static_cast<int>(i % 5), task(i));
+            }
+            CHECK(bottom == 8 && jobSystem.openCount() == 39 && jobSystem.completedCount() == 1);
+
+            CHECK(jobSystem.start(threads));
+            CHECK(!jobSystem.start(threads)); // Already running
+            CHECK(jobSystem.addJob("During the run", false) == JobSystem::npos);
+            JobSystem::RunStats stats = jobSystem.wait();
+            CHECK(jobsRun(stats) == 39);
+            CHECK(stats.skipped == 0);
+            CHECK(stats.workers.size() == threads);
+            for (size_t i = 1; i < 4; ++i)
+            {
+                CHECK(ranAt[chain[i - 1]] < ranAt[chain[i]]);
+            }
+            CHECK(ranAt[top] < ranAt[left] && ranAt[top] < ranAt[right]);
+            CHECK(ranAt[left] < ranAt[bottom] && ranAt[right] < ranAt[bottom]);
+            for (size_t job = 1; job < 40; ++job)
+            {
+                CHECK(ranAt[job] >= 0 && jobSystem.isCompleted(job));
+            }
+            CHECK(jobSystem.openCount() == 0 && jobSystem.completedCount() == 40);
+            CHECK(jobSystem.nextJob() == JobSystem::npos);
+        }
+    }
+}
+
+// A task that throws fails its job; everything downstream of it is skipped
+// and counted, and stays open, while jobs off that path still run
+void testFailureSkipsDependents()
+{
+    JobSystem jobSystem;
+    std::atomic<int> ran{0};
+    auto succeed = [&]
+    { ++ran; };
+    size_t fails = jobSystem.addTask("Fails", 0, []
+                                     { throw std::runtime_error("broken"); });
+    size_t fine = jobSystem.addTask("Fine", 0, succeed);
+    size_t child = jobSystem.addTask("Child", 0, succeed, {fails});
+    size_t grandchild = jobSystem.addTask("Grandchild", 0, succeed, {child, fine});
+    size_t sibling = jobSystem.addTask("Sibling", 0, succeed, {fine});
+    size_t last = jobSystem.addTask("Last", 0, succeed, {grandchild, sibling});
+
+    CHECK(jobSystem.start(4));
+    JobSystem::RunStats stats = jobSystem.wait();
+    CHECK(ran == 2);
+    CHECK(jobsRun(stats) == 3);
+    CHECK(stats.skipped == 3);
+    size_t failed = 0;
+    for (const JobSystem::WorkerStats &worker : stats.workers)
+    {
+        failed += worker.failed;
+    }
+    CHECK(failed == 1);
+    CHECK(jobSystem.isCompleted(fine) && jobSystem.isCompleted(sibling));
+    CHECK(!jobSystem.isCompleted(fails) && !jobSystem.isCompleted(child) && !jobSystem.isCompleted(grandchild) &&
+          !jobSystem.isCompleted(last));
+    CHECK(jobSystem.openCount() == 4 && jobSystem.completedCount() == 2);
+    CHECK(shownStatuses(jobSystem) ==
+          std::vector<std::string>({"Failed", "Completed", "Skipped", "Skipped", "Completed", "Skipped"}));
+}
+
+// Jobs waiting on an open job that has no task are left out of the run: they
+// stay idle and open until that job is completed by hand
+void testWaitingOnManualJob()
+{
+    JobSystem jobSystem;
+    std::atomic<int> ran{0};
+    auto succeed = [&]
+    { ++ran; };
+    size_t manual = jobSystem.addJob("By hand", false);
+    size_t blocked = jobSystem.addTask("Blocked", 0, succeed, {manual});
+    size_t behind = jobSystem.addTask("Behind", 0, succeed, {blocked});
+    size_t unblocked = jobSystem.addTask("Free", 0, succeed);
+
+    CHECK(jobSystem.start(2));
+    JobSystem::RunStats stats = jobSystem.wait();
+    CHECK(ran == 1 && jobsRun(stats) == 1 && stats.skipped == 0);
+    CHECK(jobSystem.isCompleted(unblocked));
+    CHECK(!jobSystem.isCompleted(manual) && !jobSystem.isCompleted(blocked) && !jobSystem.isCompleted(behind));
+    CHECK(jobSystem.openCount() == 3 && jobSystem.completedCount() == 1);
+    CHECK(shownStatuses(jobSystem) == std::vector<std::string>({"In Progress", "In Progress", "In Progress", "Completed"}));
+
+    // A run with nothing to do ends at once
+    CHECK(jobSystem.start(2));
+    stats = jobSystem.wait();
+    CHECK(ran == 1 && jobsRun(stats) == 0);
+
+    CHECK(jobSystem.setCompleted(manual, true));
+    CHECK(jobSystem.start(2));
+    stats = jobSystem.wait();
+    CHECK(ran == 3 && jobsRun(stats) == 2);
+    CHECK(jobSystem.openCount() == 0 && jobSystem.completedCount() == 4);
+    CHECK(jobSystem.wait().workers.empty()); // Nothing running
+}
+
+// Many short jobs fanning out from a few roots on more workers than cores,
+// so workers keep running out of work, sleeping and being woken
+void testManyShortJobs()
+{
+    for (int round = 0; round < 20; ++round)
+    {
+        JobSystem jobSystem;
+        std::atomic<int> ran{0};
+        auto succeed = [&]
+        { ++ran; };
+        std::vector<size_t> roots;
+        for (int i = 0; i < 4; ++i)
+        {
+            roots.push_back(jobSystem.addTask("Root", 0, succeed));
+        }
+        for (size_t i = 0; i < 2000; ++i)
+        {
+            jobSystem.addTask("Leaf", static_cast<int>(i % 7), succeed, {roots[i % roots.size()]});
+        }
+        CHECK(jobSystem.start(16));
+        JobSystem::RunStats stats = jobSystem.wait();
+        CHECK(ran == 2004 && jobsRun(stats) == 2004);
+        CHECK(jobSystem.openCount() == 0 && jobSystem.completedCount() == 2004);
+    }
+}
+
+// The open and completed lists, the per-member lists and the next-job heap
+// against a scan of a model, after random adds, reassignments, completions,
+// reopenings and runs. Every swap-and-pop and stale heap entry is exercised.
+void testIndexesMatchScan()
+{
+    struct Model
+    {
+        int priority;
+        std::string assignee; // Empty if unassigned
+        bool done;
+        bool hasTask;
+    };
+    std::mt19937 rng(21);
+    JobSystem jobSystem;
+    std::vector<Model> model;
+    const std::vector<std::string> members = {"Ann", "Ben", "Cat", "Dan", "Eve"};
+    for (size_t step = 0; step < 5000; ++step)
+    {
+        unsigned op = rng() % 20;
+        size_t job = model.empty() ? 0 : rng() % model.size();
+        if (op < 5 || model.empty())
+        {
+            const std::string &name = members[rng() % members.size()];
+            int priority = static_cast<int>(rng() % 10);
+            bool done = rng() % 4 == 0;
+            CHECK(jobSystem.addJob("Job", priority, TeamMember(name, "Developer", 40), done) == model.size());
+            model.push_back({priority, name, done, false});
+        }
+        else if (op == 5)
+        {
+            bool done = rng() % 2 == 0;
+            CHECK(jobSystem.addJob("Unassigned", done) == model.size());
+            model.push_back({0, "", done, false});
+        }
+        else if (op == 6)
+        {
+            int priority = static_cast<int>(rng() % 10);
+            CHECK(jobSystem.addTask("Task", priority, [] {}) == model.size());
+            model.push_back({priority, "", false, true});
+        }
+        else if (op < 10)
+        {
+            const std::string &name = members[rng() % members.size()];
+            CHECK(jobSystem.assignJob(job, TeamMember(name, "Developer", 40)));
+            model[job].assignee = name;
+        }
+        else if (op < 18)
+        {
+            bool done = op < 15;
+            CHECK(jobSystem.setCompleted(job, done));
+            model[job].done = done;
+        }
+        else if (op == 18)
+        {
+            CHECK(jobSystem.start(1 + rng() % 4));
+            jobSystem.wait();
+            for (Model &entry : model)
+            {
+                entry.done = entry.done || entry.hasTask;
+            }
+        }
+        else
+        {
+            CHECK(!jobSystem.assignJob(model.size(), TeamMember("Ann", "Developer", 40)));
+            CHECK(!jobSystem.setCompleted(model.size(), true));
+        }
+
+        size_t best = JobSystem::npos;
+        std::vector<size_t> byStatus[2];
+        std::map<std::string, std::vector<size_t>> openByMember;
+        for (size_t i = 0; i < model.size(); ++i)
+        {
+            CHECK(jobSystem.isCompleted(i) == model[i].done);
+            byStatus[model[i].done].push_back(i);
+            if (model[i].done)
+            {
+                continue;
+            }
+            if (!model[i].assignee.empty())
+            {
+                openByMember[model[i].assignee].push_back(i);
+            }
+            if (best == JobSystem::npos || model[i].priority > model[best].priority)
+            {
+                best = i; // Ties go to the older job
+            }
+        }
+        CHECK(jobSystem.openCount() == byStatus[0].size());
+        CHECK(jobSystem.completedCount() == byStatus[1].size());
+        for (bool done : {false, true})
+        {
+            std::vector<size_t> found = jobSystem.jobsWithStatus(done);
+            std::sort(found.begin(), found.end());
+            CHECK(found == byStatus[done]);
+        }
+        CHECK(jobSystem.nextJob() == best);
+        for (const std::string &name : members)
+        {
+            std::vector<size_t> found = jobSystem.openJobsOf(name);
+            std::sort(found.begin(), found.end());
+            CHECK(found == openByMember[name]);
+        }
+        CHECK(jobSystem.openJobsOf("Nobody").empty());
+    }
+}
+
+int main()
+{
+    testDependencyOrder();
+    testFailureSkipsDependents();
+    testWaitingOnManualJob();
+    testManyShortJobs();
+    testIndexesMatchScan();
+    if (failures > 0)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All tests passed" << std::endl;
+    return 0;
+}
@@ -1,6 +1,19 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <queue>         // For the next-job heap
+#include <unordered_map> // For the assignee index
+#include <algorithm>
+#include <functional>    // For job tasks
+#include <memory>
+#include <deque>         // For the completion bits and the worker queues
+#include <atomic>
+#include <thread>        // For running jobs
+#include <mutex>
+#include <condition_variable>
+#include <chrono>        // For run statistics
+#include <iomanip>
 
 // Base class for Employee
 class Employee
@@ -11,6 +24,10 @@ protected:
 public:
     virtual void displayInfo() const = 0; // Pure virtual function marked as const
     virtual ~Employee() = default;
+    const std::string &getName() const
+    {
+        return name;
+    }
 };
 
 // Class for Team Members
@@ -79,32 +96,605 @@ public:
     }
 };
 
-// Class to manage job statuses
+// Class to manage job statuses. Jobs are numbered in the order they are
+// added. Counts by status are O(1), a member's open jobs cost time in
+// proportion to that member's jobs, and nextJob() is the open job with the
+// highest priority (oldest first among equals).
+//
+// Jobs added with addTask/addAction also carry work to run. start() runs
+// every open job that has work on a pool of worker threads, each after the
+// jobs it depends on have completed; wait() blocks until the run is over. While
+// a run is in progress, displayJobs() and isCompleted() may be called from any
+// thread and never block. Calls that change jobs fail until wait() returns.
 class JobSystem
 {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // What one worker did during a run
+    struct WorkerStats
+    {
+        size_t jobsRun = 0;
+        size_t failed = 0;           // Jobs whose task threw
+        double busySeconds = 0;      // Time spent inside tasks
+        double queueSeconds = 0;     // Total time its jobs waited between becoming ready and starting
+        double maxQueueSeconds = 0;
+    };
+    struct RunStats
+    {
+        std::vector<WorkerStats> workers;
+        double seconds = 0; // From start() until the last job finished
+        size_t skipped = 0; // Jobs not run because a dependency failed
+    };
+
+private:
+    static constexpr size_t unassigned = static_cast<size_t>(-1);
+
+    // Status of each job in the latest run, as displayJobs() shows it
+    enum RunState : uint8_t
+    {
+        Idle, // Not part of the run
+        Waiting,
+        Queued,
+        Running,
+        Done,
+        Failed,
+        Skipped
+    };
+
     struct Job
     {
         std::string description;
-        bool isCompleted;
+        int priority;
+        size_t assignee;         // Index into assigneeNames, or unassigned
+        size_t statusPosition;   // Where the job sits in byStatus[its status]
+        size_t assigneePosition; // Where the job sits in jobsByAssignee[assignee]
+        std::function<void()> task; // Empty for jobs that are completed by hand
+        std::vector<size_t> dependsOn;
+        std::vector<size_t> dependents;
     };
     std::vector<Job> jobs;
+    std::deque<std::atomic<uint64_t>> completed; // One bit per job; workers set them during a run
+    std::vector<size_t> byStatus[2];              // Open jobs, then completed jobs, in no particular order
+
+    std::vector<std::string> assigneeNames;
+    std::unordered_map<std::string, size_t> assigneeIndex; // Name -> index into assigneeNames
+    std::vector<std::vector<size_t>> jobsByAssignee;
+
+    std::unordered_map<std::string, std::function<void()>> actions; // For addAction
+
+    // Open jobs by priority. Completing a job leaves its entry behind;
+    // nextJob() drops such entries once they reach the top.
+    struct Ranked
+    {
+        int priority;
+        size_t job;
+        bool operator<(const Ranked &other) const
+        {
+            return priority != other.priority ? priority < other.priority : job > other.job;
+        }
+    };
+    std::priority_queue<Ranked> openQueue;
+
+    // A worker's deque of ready jobs: it takes from the back of its own and
+    // steals from the front of the others'
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<size_t> jobs;
+    };
+    // Everything that only exists while a run is in progress
+    struct Execution
+    {
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+        std::vector<std::thread> workers;
+        std::mutex sleepMutex;
+        std::condition_variable wake;
+        size_t queued = 0;     // Jobs in any queue; guarded by sleepMutex
+        bool finished = false; // Guarded by sleepMutex
+        std::atomic<size_t> unfinished{0};
+        std::unique_ptr<std::atomic<uint32_t>[]> pending; // Dependencies not finished yet
+        std::unique_ptr<std::atomic<bool>[]> blocked;     // A dependency failed or was skipped
+        std::unique_ptr<std::chrono::steady_clock::time_point[]> readyAt;
+        std::vector<WorkerStats> stats; // One per worker, written only by that worker
+        std::atomic<size_t> skipped{0};
+        std::chrono::steady_clock::time_point startedAt;
+        std::chrono::steady_clock::time_point finishedAt;
+    };
+    std::unique_ptr<Execution> execution;
+    std::unique_ptr<std::atomic<uint8_t>[]> states; // RunState per job of the latest run
+    size_t stateCount = 0;
+
+    size_t assigneeFor(const std::string &memberName)
+    {
+        auto it = assigneeIndex.find(memberName);
+        if (it != assigneeIndex.end())
+        {
+            return it->second;
+        }
+        assigneeIndex.emplace(memberName, assigneeNames.size());
+        assigneeNames.push_back(memberName);
+        jobsByAssignee.emplace_back();
+        return assigneeNames.size() - 1;
+    }
+    void setBit(size_t job, bool isCompleted)
+    {
+        uint64_t mask = uint64_t(1) << (job % 64);
+        if (isCompleted)
+        {
+            completed[job / 64].fetch_or(mask, std::memory_order_release);
+        }
+        else
+        {
+            completed[job / 64].fetch_and(~mask, std::memory_order_release);
+        }
+    }
+    // Swap-and-pop: the last entry takes the moved one's place
+    void moveStatus(size_t job, bool from, bool to)
+    {
+        std::vector<size_t> &list = byStatus[from];
+        size_t position = jobs[job].statusPosition;
+        list[position] = list.back();
+        jobs[list[position]].statusPosition = position;
+        list.pop_back();
+        jobs[job].statusPosition = byStatus[to].size();
+        byStatus[to].push_back(job);
+    }
+    void unlinkAssignee(size_t job)
+    {
+        std::vector<size_t> &list = jobsByAssignee[jobs[job].assignee];
+        size_t position = jobs[job].assigneePosition;
+        list[position] = list.back();
+        jobs[list[position]].assigneePosition = position;
+        list.pop_back();
+    }
+    void linkAssignee(size_t job, size_t assignee)
+    {
+        jobs[job].assignee = assignee;
+        if (assignee != unassigned)
+        {
+            jobs[job].assigneePosition = jobsByAssignee[assignee].size();
+            jobsByAssignee[assignee].push_back(job);
+        }
+    }
+    size_t push(const std::string &description, int priority, size_t assignee, bool isCompleted)
+    {
+        size_t job = jobs.size();
+        jobs.push_back({description, priority, unassigned, byStatus[isCompleted].size(), 0, {}, {}, {}});
+        byStatus[isCompleted].push_back(job);
+        if (job % 64 == 0)
+        {
+            completed.emplace_back(0);
+        }
+        setBit(job, isCompleted);
+        linkAssignee(job, assignee);
+        if (!isCompleted)
+        {
+            openQueue.push({priority, job});
+        }
+        return job;
+    }
+    // Dependencies must already exist, which also rules out cycles
+    size_t pushTask(const std::string &description, int priority, std::function<void()> task,
+                    const std::vector<size_t> &dependsOn)
+    {
+        if (execution)
+        {
+            return npos;
+        }
+        for (size_t dependency : dependsOn)
+        {
+            if (dependency >= jobs.size())
+            {
+                return npos;
+            }
+        }
+        size_t job = push(description, priority, unassigned, false);
+        jobs[job].task = std::move(task);
+        jobs[job].dependsOn = dependsOn;
+        for (size_t dependency : dependsOn)
+        {
+            jobs[dependency].dependents.push_back(job);
+        }
+        return job;
+    }
+
+    void enqueue(size_t worker, size_t job)
+    {
+        Execution &run = *execution;
+        run.readyAt[job] = std::chrono::steady_clock::now();
+        states[job].store(Queued, std::memory_order_relaxed);
+        {
+            // Counted while the queue is still locked, so takeJob cannot count
+            // the job out before it is counted in
+            std::lock_guard<std::mutex> lock(run.queues[worker]->mutex);
+            run.queues[worker]->jobs.push_back(job);
+            std::lock_guard<std::mutex> count(run.sleepMutex);
+            ++run.queued;
+        }
+        run.wake.notify_one();
+    }
+    bool takeJob(size_t self, size_t &job)
+    {
+        Execution &run = *execution;
+        for (size_t i = 0; i < run.queues.size(); ++i)
+        {
+            WorkerQueue &queue = *run.queues[(self + i) % run.queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                if (i == 0)
+                {
+                    job = queue.jobs.back();
+                    queue.jobs.pop_back();
+                }
+                else
+                {
+                    job = queue.jobs.front();
+                    queue.jobs.pop_front();
+                }
+                std::lock_guard<std::mutex> count(run.sleepMutex);
+                --run.queued;
+                return true;
+            }
+        }
+        return false;
+    }
+    // Records how job ended and releases the dependents that were waiting
+    // only on it, onto this worker's own queue
+    void finish(size_t worker, size_t job, RunState state)
+    {
+        Execution &run = *execution;
+        std::vector<std::pair<size_t, RunState>> ended{{job, state}};
+        while (!ended.empty())
+        {
+            auto [current, outcome] = ended.back();
+            ended.pop_back();
+            if (outcome == Done)
+            {
+                setBit(current, true);
+            }
+            states[current].store(outcome, std::memory_order_release);
+            for (size_t dependent : jobs[current].dependents)
+            {
+                if (states[dependent].load(std::memory_order_relaxed) == Idle)
+                {
+                    continue; // Not part of this run
+                }
+                if (outcome != Done)
+                {
+                    run.blocked[dependent].store(true, std::memory_order_relaxed);
+                }
+                if (run.pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    if (run.blocked[dependent].load(std::memory_order_relaxed))
+                    {
+                        run.skipped.fetch_add(1, std::memory_order_relaxed);
+                        ended.push_back({dependent, Skipped});
+                    }
+                    else
+                    {
+                        enqueue(worker, dependent);
+                    }
+                }
+            }
+            if (run.unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                std::lock_guard<std::mutex> lock(run.sleepMutex);
+                run.finishedAt = std::chrono::steady_clock::now();
+                run.finished = true;
+                run.wake.notify_all();
+            }
+        }
+    }
+    void workerLoop(size_t self)
+    {
+        Execution &run = *execution;
+        WorkerStats &stats = run.stats[self];
+        size_t job;
+        while (true)
+        {
+            if (takeJob(self, job))
+            {
+                auto begin = std::chrono::steady_clock::now();
+                double queueSeconds = std::chrono::duration<double>(begin - run.readyAt[job]).count();
+                stats.queueSeconds += queueSeconds;
+                stats.maxQueueSeconds = std::max(stats.maxQueueSeconds, queueSeconds);
+                states[job].store(Running, std::memory_order_relaxed);
+                bool succeeded = true;
+                try
+                {
+                    jobs[job].task();
+                }
+                catch (...)
+                {
+                    succeeded = false;
+                }
+                stats.busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+                ++stats.jobsRun;
+                stats.failed += !succeeded;
+                finish(self, job, succeeded ? Done : Failed);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(run.sleepMutex);
+            run.wake.wait(lock, [&run]
+                          { return run.finished || run.queued > 0; });
+            if (run.finished)
+            {
+                return;
+            }
+        }
+    }
 
 public:
-    void addJob(const std::string &description, bool isCompleted)
+    JobSystem() = default;
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+    ~JobSystem()
+    {
+        wait();
+    }
+
+    // Returns the new job's number, or npos during a run
+    size_t addJob(const std::string &description, bool isCompleted)
     {
-        jobs.push_back({description, isCompleted});
+        return execution ? npos : push(description, 0, unassigned, isCompleted);
     }
+    size_t addJob(const std::string &description, int priority, const TeamMember &assignee, bool isCompleted = false)
+    {
+        return execution ? npos : push(description, priority, assigneeFor(assignee.getName()), isCompleted);
+    }
+    // An open job that runs task once every job in dependsOn has completed.
+    // Returns npos if a dependency does not exist yet.
+    size_t addTask(const std::string &description, int priority, std::function<void()> task,
+                   const std::vector<size_t> &dependsOn = {})
+    {
+        return pushTask(description, priority, std::move(task), dependsOn);
+    }
+    // Makes action available to addAction under name
+    void registerAction(const std::string &name, std::function<void()> action)
+    {
+        actions[name] = std::move(action);
+    }
+    // Like addTask, running a registered action; npos if there is no such action
+    size_t addAction(const std::string &description, int priority, const std::string &action,
+                     const std::vector<size_t> &dependsOn = {})
+    {
+        auto it = actions.find(action);
+        return it == actions.end() ? npos : pushTask(description, priority, it->second, dependsOn);
+    }
+    // False if there is no such job or a run is in progress
+    bool assignJob(size_t job, const TeamMember &assignee)
+    {
+        if (job >= jobs.size() || execution)
+        {
+            return false;
+        }
+        if (jobs[job].assignee != unassigned)
+        {
+            unlinkAssignee(job);
+        }
+        linkAssignee(job, assigneeFor(assignee.getName()));
+        return true;
+    }
+    bool setCompleted(size_t job, bool done)
+    {
+        if (job >= jobs.size() || execution)
+        {
+            return false;
+        }
+        if (job < stateCount)
+        {
+            states[job].store(Idle, std::memory_order_relaxed); // Overrides how the last run left it
+        }
+        if (isCompleted(job) == done)
+        {
+            return true;
+        }
+        moveStatus(job, !done, done);
+        setBit(job, done);
+        if (!done)
+        {
+            openQueue.push({jobs[job].priority, job}); // Reopened
+        }
+        return true;
+    }
+    bool isCompleted(size_t job) const
+    {
+        return (completed[job / 64].load(std::memory_order_acquire) >> (job % 64)) & 1;
+    }
+    // Both counts catch up with a run once wait() returns
+    size_t openCount() const
+    {
+        return byStatus[0].size();
+    }
+    size_t completedCount() const
+    {
+        return byStatus[1].size();
+    }
+    // The open job with the highest priority, or npos if every job is done
+    size_t nextJob()
+    {
+        while (!openQueue.empty())
+        {
+            Ranked top = openQueue.top();
+            if (!isCompleted(top.job))
+            {
+                return top.job;
+            }
+            openQueue.pop(); // Completed since it was queued
+        }
+        return npos;
+    }
+    // The open or the completed jobs, in no particular order; like the
+    // counts, they catch up with a run once wait() returns
+    const std::vector<size_t> &jobsWithStatus(bool isCompleted) const
+    {
+        return byStatus[isCompleted];
+    }
+    // The open jobs assigned to memberName, in no particular order
+    std::vector<size_t> openJobsOf(const std::string &memberName) const
+    {
+        std::vector<size_t> open;
+        auto it = assigneeIndex.find(memberName);
+        if (it != assigneeIndex.end())
+        {
+            for (size_t job : jobsByAssignee[it->second])
+            {
+                if (!isCompleted(job))
+                {
+                    open.push_back(job);
+                }
+            }
+        }
+        return open;
+    }
+    const std::string &getDescription(size_t job) const
+    {
+        return jobs[job].description;
+    }
+
+    // Runs every open job that has a task, on threadCount workers. Jobs that
+    // depend on an open job without a task stay open. False if a run is
+    // already in progress.
+    bool start(unsigned threadCount)
+    {
+        if (execution)
+        {
+            return false;
+        }
+        threadCount = std::max(threadCount, 1u);
+        execution = std::make_unique<Execution>();
+        Execution &run = *execution;
+        run.pending = std::make_unique<std::atomic<uint32_t>[]>(jobs.size());
+        run.blocked = std::make_unique<std::atomic<bool>[]>(jobs.size());
+        run.readyAt = std::make_unique<std::chrono::steady_clock::time_point[]>(jobs.size());
+        run.stats.resize(threadCount);
+        states = std::make_unique<std::atomic<uint8_t>[]>(jobs.size());
+        stateCount = jobs.size();
+
+        // Dependencies always have lower numbers, so one pass in order sees
+        // whether each of them will run before deciding on the job itself
+        std::vector<size_t> ready;
+        size_t unfinished = 0;
+        for (size_t job = 0; job < jobs.size(); ++job)
+        {
+            bool runs = jobs[job].task && !isCompleted(job);
+            uint32_t pending = 0;
+            for (size_t dependency : jobs[job].dependsOn)
+            {
+                if (!isCompleted(dependency))
+                {
+                    runs = runs && states[dependency].load(std::memory_order_relaxed) != Idle;
+                    ++pending;
+                }
+            }
+            states[job].store(runs ? Waiting : Idle, std::memory_order_relaxed);
+            run.pending[job].store(pending, std::memory_order_relaxed);
+            run.blocked[job].store(false, std::memory_order_relaxed);
+            if (runs)
+            {
+                ++unfinished;
+                if (pending == 0)
+                {
+                    ready.push_back(job);
+                }
+            }
+        }
+        run.unfinished.store(unfinished, std::memory_order_relaxed);
+        run.finished = unfinished == 0;
+
+        // Workers take from the back of their own queue, so deal the ready jobs
+        // lowest priority first to start the most important ones first
+        std::stable_sort(ready.begin(), ready.end(), [this](size_t a, size_t b)
+                         { return jobs[a].priority < jobs[b].priority; });
+        run.startedAt = run.finishedAt = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < threadCount; ++i)
+        {
+            run.queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (size_t i = 0; i < ready.size(); ++i)
+        {
+            size_t worker = i % threadCount;
+            run.readyAt[ready[i]] = run.startedAt;
+            states[ready[i]].store(Queued, std::memory_order_relaxed);
+            run.queues[worker]->jobs.push_back(ready[i]);
+        }
+        run.queued = ready.size();
+        for (unsigned i = 0; i < threadCount; ++i)
+        {
+            run.workers.emplace_back([this, i]
+                                     { workerLoop(i); });
+        }
+        return true;
+    }
+    // Blocks until the run started by start() is over and brings the open and
+    // completed counts up to date. Returns empty stats if nothing was running.
+    RunStats wait()
+    {
+        RunStats result;
+        if (!execution)
+        {
+            return result;
+        }
+        Execution &run = *execution;
+        for (auto &worker : run.workers)
+        {
+            worker.join();
+        }
+        for (size_t job = 0; job < stateCount; ++job)
+        {
+            if (states[job].load(std::memory_order_relaxed) == Done)
+            {
+                moveStatus(job, false, true);
+            }
+        }
+        result.workers = std::move(run.stats);
+        result.seconds = std::chrono::duration<double>(run.finishedAt - run.startedAt).count();
+        result.skipped = run.skipped.load(std::memory_order_relaxed);
+        execution.reset();
+        return result;
+    }
+    static void displayRunStats(const RunStats &stats)
+    {
+        size_t total = 0;
+        std::cout << "Worker    Jobs  Failed  Busy (s)  Avg queue (ms)  Max queue (ms)\n";
+        for (size_t i = 0; i < stats.workers.size(); ++i)
+        {
+            const WorkerStats &worker = stats.workers[i];
+            total += worker.jobsRun;
+            double averageQueue = worker.jobsRun ? worker.queueSeconds / worker.jobsRun : 0;
+            std::cout << std::setw(6) << i << std::setw(8) << worker.jobsRun << std::setw(8) << worker.failed
+                      << std::setw(10) << worker.busySeconds << std::setw(16) << averageQueue * 1000
+                      << std::setw(16) << worker.maxQueueSeconds * 1000 << "\n";
+        }
+        std::cout << total << " jobs in " << stats.seconds << " s ("
+                  << (stats.seconds > 0 ? total / stats.seconds : 0) << " jobs/s), "
+                  << stats.skipped << " skipped\n";
+    }
+    // Safe to call from any thread during a run
     void displayJobs() const
     {
         std::cout << "Job Status:\n";
-        for (const auto &job : jobs)
+        for (size_t job = 0; job < jobs.size(); ++job)
         {
-            std::cout << "- " << job.description << " ["
-                      << (job.isCompleted ? "Completed" : "In Progress") << "]\n";
+            uint8_t state = job < stateCount ? states[job].load(std::memory_order_acquire) : uint8_t(Idle);
+            const char *status = isCompleted(job)  ? "Completed"
+                                 : state == Running ? "Running"
+                                 : state == Failed  ? "Failed"
+                                 : state == Skipped ? "Skipped"
+                                                    : "In Progress";
+            std::cout << "- " << jobs[job].description << " [" << status << "]";
+            if (jobs[job].assignee != unassigned)
+            {
+                std::cout << " (" << assigneeNames[jobs[job].assignee] << ", priority " << jobs[job].priority << ")";
+            }
+            std::cout << "\n";
         }
     }
 };
 
+#ifndef EMS_NO_MAIN // tests_version1.cpp includes this file and brings its own main
 // Main function
 int main()
 {
@@ -119,17 +709,21 @@ int main()
     CTO ctoCloud("Frank", "Cloud Infrastructure");
 
     // Add team members to CTOs
-    ctoFrontend.addTeamMember(TeamMember("John", "React Developer", 40));
+    TeamMember john("John", "React Developer", 40);
+    ctoFrontend.addTeamMember(john);
     ctoFrontend.addTeamMember(TeamMember("Jane", "Vue.js Developer", 35));
 
-    ctoBackend.addTeamMember(TeamMember("Jim", "Node.js Developer", 38));
+    TeamMember jim("Jim", "Node.js Developer", 38);
+    ctoBackend.addTeamMember(jim);
     ctoBackend.addTeamMember(TeamMember("Jill", "Java Developer", 42));
 
-    ctoAI.addTeamMember(TeamMember("Anne", "Machine Learning Engineer", 45));
+    TeamMember anne("Anne", "Machine Learning Engineer", 45);
+    ctoAI.addTeamMember(anne);
     ctoAI.addTeamMember(TeamMember("Paul", "Data Scientist", 37));
 
     ctoDevOps.addTeamMember(TeamMember("Sam", "AWS Specialist", 40));
-    ctoDevOps.addTeamMember(TeamMember("Lily", "Kubernetes Expert", 36));
+    TeamMember lily("Lily", "Kubernetes Expert", 36);
+    ctoDevOps.addTeamMember(lily);
 
     ctoCloud.addTeamMember(TeamMember("Mark", "Azure Specialist", 41));
     ctoCloud.addTeamMember(TeamMember("Nina", "GCP Engineer", 39));
@@ -147,14 +741,42 @@ int main()
 
     // Manage and display job statuses
     JobSystem jobSystem;
-    jobSystem.addJob("Develop Frontend Dashboard", false);
-    jobSystem.addJob("Set up Backend API", true);
-    jobSystem.addJob("Train AI Model", false);
-    jobSystem.addJob("Deploy to Kubernetes", true);
+    jobSystem.addJob("Develop Frontend Dashboard", 2, john, false);
+    jobSystem.addJob("Set up Backend API", 3, jim, true);
+    jobSystem.addJob("Train AI Model", 5, anne, false);
+    jobSystem.addJob("Deploy to Kubernetes", 4, lily, true);
     jobSystem.addJob("Optimize Cloud Infrastructure", false);
+    jobSystem.addJob("Fix Dashboard Layout", 1, john, false);
 
     std::cout << "\nJob Status:\n";
     jobSystem.displayJobs();
+    std::cout << jobSystem.openCount() << " open, " << jobSystem.completedCount() << " completed\n";
+
+    size_t next = jobSystem.nextJob();
+    if (next != JobSystem::npos)
+    {
+        std::cout << "Next job: " << jobSystem.getDescription(next) << "\n";
+    }
+    std::cout << "Open jobs for " << john.getName() << ":\n";
+    for (size_t job : jobSystem.openJobsOf(john.getName()))
+    {
+        std::cout << "- " << jobSystem.getDescription(job) << "\n";
+    }
+
+    // Run a small release pipeline: the tests wait for the build, packaging for both
+    std::atomic<int> steps{0};
+    jobSystem.registerAction("step", [&steps]
+                             { ++steps; });
+    size_t build = jobSystem.addAction("Build Release", 5, "step");
+    size_t test = jobSystem.addAction("Run Tests", 4, "step", {build});
+    jobSystem.addAction("Package Release", 3, "step", {build, test});
+    jobSystem.start(std::thread::hardware_concurrency());
+    JobSystem::RunStats stats = jobSystem.wait();
+
+    std::cout << "\nAfter running " << steps << " pipeline steps:\n";
+    jobSystem.displayJobs();
+    JobSystem::displayRunStats(stats);
 
     return 0;
 }
+#endif
@@ -1,8 +1,14 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <iomanip>   // For formatting the table
-#include <algorithm> // For std::remove_if
+#include <string_view>
+#include <unordered_map> // For the CTO name index
+#include <iomanip>       // For formatting the table
+#include <algorithm>     // For std::remove_if
+#include <charconv>      // For std::from_chars in batch mode
+#include <chrono>        // For batch throughput
+#include <cstdio>        // For the buffered batch reader
+#include <cstring>
 
 // Base class for Employee
 class Employee
@@ -105,6 +111,7 @@ public:
 class CEO : public Employee
 {
     std::vector<CTO> ctoList;
+    std::unordered_map<std::string, size_t> ctoIndex; // CTO name -> position in ctoList
 
 public:
     CEO(std::string n)
@@ -113,6 +120,8 @@ public:
     }
     void addCTO(const CTO &cto)
     {
+        // The first CTO added under a name keeps it, like the old linear scan did
+        ctoIndex.emplace(cto.getName(), ctoList.size());
         ctoList.push_back(cto);
     }
     void displayInfo() const override
@@ -126,17 +135,202 @@ public:
     }
     CTO *getCTO(const std::string &ctoName)
     {
-        for (auto &cto : ctoList)
+        auto it = ctoIndex.find(ctoName);
+        if (it == ctoIndex.end())
         {
-            if (cto.getName() == ctoName)
+            return nullptr;
+        }
+        return &ctoList[it->second];
+    }
+};
+
+// Reads a batch command stream in large chunks and hands it out line by line,
+// so loading a big org does not pay for one stream extraction per field
+class BatchReader
+{
+    std::FILE *in;
+    std::vector<char> buffer;
+    size_t begin = 0; // First unread byte in buffer
+    size_t end = 0;   // One past the last filled byte in buffer
+    bool eof = false;
+
+public:
+    explicit BatchReader(std::FILE *input) : in(input), buffer(1 << 20) {}
+    bool nextLine(std::string_view &line)
+    {
+        while (true)
+        {
+            const char *start = buffer.data() + begin;
+            const char *newline = static_cast<const char *>(std::memchr(start, '\n', end - begin));
+            if (newline || (eof && begin < end))
             {
-                return &cto;
+                size_t length = newline ? static_cast<size_t>(newline - start) : end - begin;
+                begin += newline ? length + 1 : length;
+                if (length > 0 && start[length - 1] == '\r')
+                {
+                    --length;
+                }
+                line = std::string_view(start, length);
+                return true;
             }
+            if (eof)
+            {
+                return false;
+            }
+            // Keep the unfinished line, moved to the front, and refill behind it
+            size_t partial = end - begin;
+            if (partial == buffer.size())
+            {
+                buffer.resize(buffer.size() * 2);
+            }
+            std::memmove(buffer.data(), buffer.data() + begin, partial);
+            begin = 0;
+            end = partial;
+            size_t got = std::fread(buffer.data() + end, 1, buffer.size() - end, in);
+            end += got;
+            eof = (got == 0);
         }
-        return nullptr;
     }
 };
 
+// Splits text on '|' into at most maxFields fields; returns how many were found
+size_t splitFields(std::string_view text, std::string_view *fields, size_t maxFields)
+{
+    size_t count = 0;
+    while (count < maxFields)
+    {
+        size_t bar = text.find('|');
+        fields[count++] = text.substr(0, bar);
+        if (bar == std::string_view::npos)
+        {
+            return count;
+        }
+        text.remove_prefix(bar + 1);
+    }
+    return maxFields + 1; // More fields than expected
+}
+
+template <typename T>
+bool parseNumber(std::string_view text, T &value)
+{
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// Runs one batch command line; returns an error message, or nullptr on success
+const char *runBatchCommand(CEO &ceo, std::string_view line)
+{
+    size_t space = line.find(' ');
+    std::string_view command = line.substr(0, space);
+    std::string_view args = space == std::string_view::npos ? std::string_view() : line.substr(space + 1);
+    std::string_view fields[4];
+
+    if (command == "ADD_CTO")
+    {
+        if (splitFields(args, fields, 2) != 2)
+        {
+            return "expected ADD_CTO name|field";
+        }
+        ceo.addCTO(CTO(std::string(fields[0]), std::string(fields[1])));
+    }
+    else if (command == "ADD_MEMBER" || command == "MODIFY_MEMBER")
+    {
+        int hours;
+        if (splitFields(args, fields, 4) != 4)
+        {
+            return "expected cto|name|job|hours";
+        }
+        if (!parseNumber(fields[3], hours))
+        {
+            return "invalid hours";
+        }
+        CTO *cto = ceo.getCTO(std::string(fields[0]));
+        if (!cto)
+        {
+            return "CTO not found";
+        }
+        if (command == "ADD_MEMBER")
+        {
+            cto->addNewMember(TeamMember(std::string(fields[1]), std::string(fields[2]), hours));
+        }
+        else
+        {
+            cto->modifyTeamMember(std::string(fields[1]), std::string(fields[2]), hours);
+        }
+    }
+    else if (command == "REMOVE_MEMBER")
+    {
+        if (splitFields(args, fields, 2) != 2)
+        {
+            return "expected REMOVE_MEMBER cto|name";
+        }
+        CTO *cto = ceo.getCTO(std::string(fields[0]));
+        if (!cto)
+        {
+            return "CTO not found";
+        }
+        cto->removeTeamMember(std::string(fields[1]));
+    }
+    else if (command == "DISPLAY")
+    {
+        ceo.displayInfo();
+    }
+    else
+    {
+        return "unknown command";
+    }
+    return nullptr;
+}
+
+// Applies a command stream without prompts, one command per line:
+//   ADD_CTO name|field
+//   ADD_MEMBER cto|name|job|hours
+//   MODIFY_MEMBER cto|name|job|hours
+//   REMOVE_MEMBER cto|name
+//   DISPLAY
+// Blank lines and lines starting with '#' are skipped. Errors are reported
+// with their line number and do not stop the batch.
+int runBatch(CEO &ceo, const char *path)
+{
+    bool fromStdin = std::strcmp(path, "-") == 0;
+    std::FILE *in = fromStdin ? stdin : std::fopen(path, "rb");
+    if (!in)
+    {
+        std::cerr << "Cannot open batch file: " << path << "\n";
+        return 1;
+    }
+    std::ios::sync_with_stdio(false);
+
+    BatchReader reader(in);
+    std::string_view line;
+    size_t lineNumber = 0, commands = 0, errors = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (reader.nextLine(line))
+    {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        ++commands;
+        if (const char *error = runBatchCommand(ceo, line))
+        {
+            ++errors;
+            std::cerr << "Line " << lineNumber << ": " << error << "\n";
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!fromStdin)
+    {
+        std::fclose(in);
+    }
+
+    std::cout.flush();
+    std::cerr << "Processed " << commands << " commands (" << errors << " errors) in "
+              << seconds << " s, " << (seconds > 0 ? commands / seconds : 0) << " commands/s\n";
+    return errors == 0 ? 0 : 1;
+}
+
 void displayMenu()
 {
     std::cout << "\n--- Employee Management System ---\n";
@@ -149,8 +343,16 @@ void displayMenu()
     std::cout << "Enter your choice: ";
 }
 
-int main()
+#ifndef EMS_NO_MAIN // microbench.cpp includes this file and brings its own main
+int main(int argc, char *argv[])
 {
+    // "--batch [file]" applies a command file (or stdin) instead of showing the menu
+    if (argc > 1 && std::strcmp(argv[1], "--batch") == 0)
+    {
+        CEO ceo("Ahmad Ayedi");
+        return runBatch(ceo, argc > 2 ? argv[2] : "-");
+    }
+
     CEO ceo("Ahmad Ayedi");
     int choice;
 
@@ -251,3 +453,4 @@ int main()
 
     return 0;
 }
+#endif
@@ -1,177 +1,5373 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <iomanip>   // For formatting the table
-#include <algorithm> // For max_element
+#include <string_view>
+#include <unordered_map> // For the name indexes
+#include <unordered_set> // For checking transfer batches
+#include <algorithm>     // For max_element
+#include <functional>    // For std::greater
+#include <set>           // For the CTO leaderboard
+#include <limits>        // For the min/max kernel seeds
+#include <cmath>         // For std::isfinite
+#include <charconv>      // For std::from_chars/to_chars in batch mode and reports
+#include <chrono>        // For batch throughput
+#include <cstdio>        // For the buffered batch reader
+#include <cstring>
+#include <cstdint>       // For the fixed-width snapshot fields
+#include <memory>        // For the CEO's write-ahead log
+#include <filesystem>    // For truncating the write-ahead log
+#include <thread>        // For the parallel CSV importer and the aggregation pool
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <queue>         // For best-first name completion
+#include <array>
+#include <atomic>        // For publishing read snapshots
+#include <stdexcept>
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h> // For mapping snapshots
+#include <io.h>      // For _commit
+#else
+#include <fcntl.h> // For mapping snapshots
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h> // AVX2 aggregation kernels; build with -mavx2 or -march=native
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h> // For __rdtsc and _BitScanReverse64 in the operation stats
+#elif defined(__x86_64__)
+#include <x86intrin.h> // For __rdtsc in the operation stats
+#endif
 
-// Base class for Employee
+// Formats report tables into one reusable buffer and writes it out in large
+// chunks, instead of one flushed stream write per row. Output matches the
+// old std::setw/std::endl layout byte for byte.
+class ReportWriter
+{
+    std::ostream &out;
+    std::string buffer;
+    static constexpr size_t chunkSize = 1 << 16;
+
+    void pad(size_t length, size_t width)
+    {
+        if (length < width)
+        {
+            buffer.append(width - length, ' ');
+        }
+    }
+
+public:
+    explicit ReportWriter(std::ostream &os) : out(os)
+    {
+        buffer.reserve(chunkSize + 256);
+    }
+    ~ReportWriter()
+    {
+        flush();
+    }
+    ReportWriter &text(std::string_view value)
+    {
+        buffer.append(value);
+        return *this;
+    }
+    // Right-aligned in a field of width characters, like std::setw
+    ReportWriter &column(std::string_view value, size_t width)
+    {
+        pad(value.size(), width);
+        buffer.append(value);
+        return *this;
+    }
+    ReportWriter &column(int value, size_t width)
+    {
+        char digits[16];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        return column(std::string_view(digits, result.ptr - digits), width);
+    }
+    ReportWriter &column(size_t value, size_t width)
+    {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        return column(std::string_view(digits, result.ptr - digits), width);
+    }
+    // Formats like the stream default for doubles (%g with 6 significant digits)
+    ReportWriter &column(double value, size_t width)
+    {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, 6);
+        return column(std::string_view(digits, result.ptr - digits), width);
+    }
+    ReportWriter &repeat(char c, size_t count)
+    {
+        buffer.append(count, c);
+        return *this;
+    }
+    // Ends a row; the buffer only goes out once a whole chunk has built up
+    void endRow()
+    {
+        buffer.push_back('\n');
+        if (buffer.size() >= chunkSize)
+        {
+            out.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    void flush()
+    {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+        out.flush();
+    }
+};
+
+// Base class for Employee. Dispatch is static (CRTP): nothing holds an
+// Employee pointer, so no record pays for a vtable pointer. Derived classes
+// provide writeReport(ReportWriter &).
+template <typename Derived>
 class Employee
 {
-protected:
-    std::string name;
+protected:
+    std::string name;
+
+    ~Employee() = default;
+
+public:
+    void displayInfo() const
+    {
+        ReportWriter report(std::cout);
+        static_cast<const Derived *>(this)->writeReport(report);
+    }
+    const std::string &getName() const
+    {
+        return name;
+    }
+};
+
+// Class for Team Members
+class TeamMember : public Employee<TeamMember>
+{
+    std::string job;
+    int hoursWorked;
+    double contribution;
+
+public:
+    TeamMember(std::string n, std::string j, int h, double c) : job(std::move(j)), hoursWorked(h), contribution(c)
+    {
+        name = std::move(n);
+    }
+    void writeReport(ReportWriter &report) const
+    {
+        writeRow(report, name, job, hoursWorked, contribution);
+    }
+    // One row of a CTO's team table
+    static void writeRow(ReportWriter &report, std::string_view name, std::string_view job, int hours, double contribution)
+    {
+        report.column(name, 15).column(job, 20).column(hours, 10).column(contribution, 15).endRow();
+    }
+    const std::string &getJob() const
+    {
+        return job;
+    }
+    int getHours() const
+    {
+        return hoursWorked;
+    }
+    double getContribution() const
+    {
+        return contribution;
+    }
+    void modifyJob(const std::string &newJob)
+    {
+        job = newJob;
+    }
+    void modifyHours(int newHours)
+    {
+        hoursWorked = newHours;
+    }
+    void modifyContribution(double newContribution)
+    {
+        contribution = newContribution;
+    }
+};
+
+// Min, max and mean of one numeric team column
+struct ColumnStats
+{
+    double min = 0;
+    double max = 0;
+    double mean = 0;
+};
+
+// Aggregation kernels over the numeric team columns. Each has an AVX2 path
+// and a scalar fallback for builds without AVX2.
+double sumContributions(const double *values, size_t count)
+{
+    size_t i = 0;
+    double total = 0;
+#if defined(__AVX2__)
+    // Four independent accumulators hide the add latency
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    for (; i + 16 <= count; i += 16)
+    {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(values + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(values + i + 4));
+        acc2 = _mm256_add_pd(acc2, _mm256_loadu_pd(values + i + 8));
+        acc3 = _mm256_add_pd(acc3, _mm256_loadu_pd(values + i + 12));
+    }
+    __m256d acc = _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3));
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+    for (; i < count; ++i)
+    {
+        total += values[i];
+    }
+    return total;
+}
+
+long long sumHours(const int *values, size_t count)
+{
+    size_t i = 0;
+    long long total = 0;
+#if defined(__AVX2__)
+    // Widen to 64-bit lanes so large teams cannot overflow
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    long long lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), _mm256_add_epi64(acc0, acc1));
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < count; ++i)
+    {
+        total += values[i];
+    }
+    return total;
+}
+
+ColumnStats contributionStats(const double *values, size_t count)
+{
+    ColumnStats stats;
+    if (count == 0)
+    {
+        return stats;
+    }
+    size_t i = 0;
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -std::numeric_limits<double>::infinity();
+    double total = 0;
+#if defined(__AVX2__)
+    __m256d vmin = _mm256_set1_pd(lo), vmax = _mm256_set1_pd(hi), vsum = _mm256_setzero_pd();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d v = _mm256_loadu_pd(values + i);
+        vmin = _mm256_min_pd(vmin, v);
+        vmax = _mm256_max_pd(vmax, v);
+        vsum = _mm256_add_pd(vsum, v);
+    }
+    double mins[4], maxs[4], sums[4];
+    _mm256_storeu_pd(mins, vmin);
+    _mm256_storeu_pd(maxs, vmax);
+    _mm256_storeu_pd(sums, vsum);
+    for (int lane = 0; lane < 4; ++lane)
+    {
+        lo = std::min(lo, mins[lane]);
+        hi = std::max(hi, maxs[lane]);
+        total += sums[lane];
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+        total += values[i];
+    }
+    stats.min = lo;
+    stats.max = hi;
+    stats.mean = total / count;
+    return stats;
+}
+
+ColumnStats hoursStats(const int *values, size_t count)
+{
+    ColumnStats stats;
+    if (count == 0)
+    {
+        return stats;
+    }
+    size_t i = 0;
+    int lo = std::numeric_limits<int>::max();
+    int hi = std::numeric_limits<int>::min();
+#if defined(__AVX2__)
+    __m256i vmin = _mm256_set1_epi32(lo), vmax = _mm256_set1_epi32(hi);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+        vmin = _mm256_min_epi32(vmin, v);
+        vmax = _mm256_max_epi32(vmax, v);
+    }
+    int mins[8], maxs[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(mins), vmin);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(maxs), vmax);
+    for (int lane = 0; lane < 8; ++lane)
+    {
+        lo = std::min(lo, mins[lane]);
+        hi = std::max(hi, maxs[lane]);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+    }
+    stats.min = lo;
+    stats.max = hi;
+    stats.mean = static_cast<double>(sumHours(values, count)) / count;
+    return stats;
+}
+
+// Count, sum, min and max of both numeric columns over some set of members.
+// Partial aggregates of disjoint sets combine with merge.
+struct TeamAggregate
+{
+    size_t count = 0;
+    long long hoursSum = 0;
+    double contributionSum = 0;
+    int hoursMin = std::numeric_limits<int>::max();
+    int hoursMax = std::numeric_limits<int>::min();
+    double contributionMin = std::numeric_limits<double>::infinity();
+    double contributionMax = -std::numeric_limits<double>::infinity();
+
+    void add(int hours, double contribution)
+    {
+        ++count;
+        hoursSum += hours;
+        contributionSum += contribution;
+        hoursMin = std::min(hoursMin, hours);
+        hoursMax = std::max(hoursMax, hours);
+        contributionMin = std::min(contributionMin, contribution);
+        contributionMax = std::max(contributionMax, contribution);
+    }
+    void merge(const TeamAggregate &other)
+    {
+        count += other.count;
+        hoursSum += other.hoursSum;
+        contributionSum += other.contributionSum;
+        hoursMin = std::min(hoursMin, other.hoursMin);
+        hoursMax = std::max(hoursMax, other.hoursMax);
+        contributionMin = std::min(contributionMin, other.contributionMin);
+        contributionMax = std::max(contributionMax, other.contributionMax);
+    }
+    // All zeros for an empty set, like TeamStore's column stats
+    ColumnStats hours() const
+    {
+        if (count == 0)
+        {
+            return {};
+        }
+        return {static_cast<double>(hoursMin), static_cast<double>(hoursMax), static_cast<double>(hoursSum) / count};
+    }
+    ColumnStats contribution() const
+    {
+        if (count == 0)
+        {
+            return {};
+        }
+        return {contributionMin, contributionMax, contributionSum / count};
+    }
+};
+
+// Both columns in one pass over count members, all of them live
+TeamAggregate aggregateColumns(const int *hours, const double *contributions, size_t count)
+{
+    TeamAggregate result;
+    size_t i = 0;
+#if defined(__AVX2__)
+    if (count >= 4)
+    {
+        __m256d cmin = _mm256_set1_pd(result.contributionMin), cmax = _mm256_set1_pd(result.contributionMax);
+        __m256d csum = _mm256_setzero_pd();
+        __m128i hmin = _mm_set1_epi32(result.hoursMin), hmax = _mm_set1_epi32(result.hoursMax);
+        __m256i hsum = _mm256_setzero_si256();
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256d c = _mm256_loadu_pd(contributions + i);
+            cmin = _mm256_min_pd(cmin, c);
+            cmax = _mm256_max_pd(cmax, c);
+            csum = _mm256_add_pd(csum, c);
+            __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hours + i));
+            hmin = _mm_min_epi32(hmin, h);
+            hmax = _mm_max_epi32(hmax, h);
+            hsum = _mm256_add_epi64(hsum, _mm256_cvtepi32_epi64(h));
+        }
+        double mins[4], maxs[4], sums[4];
+        int hmins[4], hmaxs[4];
+        long long hsums[4];
+        _mm256_storeu_pd(mins, cmin);
+        _mm256_storeu_pd(maxs, cmax);
+        _mm256_storeu_pd(sums, csum);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(hmins), hmin);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(hmaxs), hmax);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(hsums), hsum);
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            result.contributionMin = std::min(result.contributionMin, mins[lane]);
+            result.contributionMax = std::max(result.contributionMax, maxs[lane]);
+            result.contributionSum += sums[lane];
+            result.hoursMin = std::min(result.hoursMin, hmins[lane]);
+            result.hoursMax = std::max(result.hoursMax, hmaxs[lane]);
+            result.hoursSum += hsums[lane];
+        }
+        result.count = i;
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        result.add(hours[i], contributions[i]);
+    }
+    return result;
+}
+
+// Interns strings that repeat across the org, such as job titles and CTO
+// fields. Each distinct string is stored once in an arena of large blocks and
+// named by a 32-bit ID, so equal strings have equal IDs. Interning and find
+// belong to the thread that mutates the org; get may also be called from
+// reader threads for IDs they saw in a published OrgSnapshot.
+class StringPool
+{
+    static constexpr size_t blockSize = 64 * 1024;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t blockUsed = blockSize;
+    // ID -> text inside blocks, in blocks of IDs under a fixed directory, so
+    // an entry never moves once written even as more strings are interned
+    static constexpr size_t idBlockShift = 16;
+    static constexpr size_t idBlockSize = size_t(1) << idBlockShift;
+    std::array<std::unique_ptr<std::string_view[]>, 4096> idBlocks;
+    size_t count = 0;
+    std::unordered_map<std::string_view, uint32_t> ids;
+
+    std::string_view store(std::string_view text)
+    {
+        if (text.size() > blockSize / 4)
+        {
+            // Long strings get a block of their own so they do not waste the current one
+            auto block = std::make_unique<char[]>(text.size());
+            char *copy = block.get();
+            blocks.insert(blocks.empty() ? blocks.end() : blocks.end() - 1, std::move(block));
+            std::memcpy(copy, text.data(), text.size());
+            return std::string_view(copy, text.size());
+        }
+        if (blockUsed + text.size() > blockSize)
+        {
+            blocks.push_back(std::make_unique<char[]>(blockSize));
+            blockUsed = 0;
+        }
+        char *copy = blocks.back().get() + blockUsed;
+        std::memcpy(copy, text.data(), text.size());
+        blockUsed += text.size();
+        return std::string_view(copy, text.size());
+    }
+
+public:
+    static constexpr uint32_t none = UINT32_MAX;
+
+    StringPool() = default;
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+
+    uint32_t intern(std::string_view text)
+    {
+        auto it = ids.find(text);
+        if (it != ids.end())
+        {
+            return it->second;
+        }
+        size_t block = count >> idBlockShift;
+        if (block == idBlocks.size())
+        {
+            throw std::length_error("StringPool is full");
+        }
+        if (!idBlocks[block])
+        {
+            idBlocks[block] = std::make_unique<std::string_view[]>(idBlockSize);
+        }
+        std::string_view stored = store(text);
+        uint32_t id = static_cast<uint32_t>(count++);
+        idBlocks[block][id & (idBlockSize - 1)] = stored;
+        ids.emplace(stored, id);
+        return id;
+    }
+    // The ID of text, or none if it was never interned
+    uint32_t find(std::string_view text) const
+    {
+        auto it = ids.find(text);
+        return it == ids.end() ? none : it->second;
+    }
+    std::string_view get(uint32_t id) const
+    {
+        return idBlocks[id >> idBlockShift][id & (idBlockSize - 1)];
+    }
+    size_t size() const
+    {
+        return count;
+    }
+};
+
+// The pool shared by every CTO and team in the program
+StringPool &sharedStrings()
+{
+    static StringPool pool;
+    return pool;
+}
+
+// A column that grows in fixed-size blocks. Elements never move once
+// written, so their addresses stay valid and growing never copies them.
+template <typename T>
+class ChunkedColumn
+{
+public:
+    static constexpr size_t blockShift = 14;
+    static constexpr size_t blockSize = size_t(1) << blockShift; // Elements per block
+
+private:
+    std::vector<std::unique_ptr<T[]>> blocks;
+    size_t count = 0;
+
+public:
+    ChunkedColumn() = default;
+    ChunkedColumn(const ChunkedColumn &other) : count(other.count)
+    {
+        for (const auto &block : other.blocks)
+        {
+            blocks.push_back(std::make_unique<T[]>(blockSize));
+            std::copy(block.get(), block.get() + blockSize, blocks.back().get());
+        }
+    }
+    ChunkedColumn(ChunkedColumn &&) noexcept = default;
+    ChunkedColumn &operator=(ChunkedColumn other) noexcept
+    {
+        blocks.swap(other.blocks);
+        std::swap(count, other.count);
+        return *this;
+    }
+    size_t size() const
+    {
+        return count;
+    }
+    T &operator[](size_t i)
+    {
+        return blocks[i >> blockShift][i & (blockSize - 1)];
+    }
+    const T &operator[](size_t i) const
+    {
+        return blocks[i >> blockShift][i & (blockSize - 1)];
+    }
+    void reserve(size_t capacity)
+    {
+        while (blocks.size() * blockSize < capacity)
+        {
+            blocks.push_back(std::make_unique<T[]>(blockSize));
+        }
+    }
+    void push_back(T value)
+    {
+        reserve(count + 1);
+        (*this)[count++] = std::move(value);
+    }
+    // Calls fn(values, length) for each contiguous run of elements, in order
+    template <typename Fn>
+    void forEachRun(Fn fn) const
+    {
+        for (size_t first = 0; first < count; first += blockSize)
+        {
+            fn(blocks[first >> blockShift].get(), std::min(blockSize, count - first));
+        }
+    }
+};
+
+// Generational handle to a team member of one CTO. It stays valid while the
+// member lives, however many others come and go; once the member is removed
+// its slot's generation moves on and the handle stops resolving.
+struct MemberHandle
+{
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+};
+
+// Storage for a CTO's team: a pool of member slots. Each field lives in its
+// own column, so aggregate scans only touch the numbers they need, and the
+// columns grow in blocks, so members never move. Removing a member frees its
+// slot for the next one added; no other member shifts. Free slots hold zero
+// hours and contribution, so column sums need no masking.
+class TeamStore
+{
+    ChunkedColumn<std::string> names;
+    ChunkedColumn<uint32_t> jobs; // IDs in sharedStrings()
+    ChunkedColumn<int> hours;
+    ChunkedColumn<double> contributions;
+    ChunkedColumn<uint8_t> alive;
+    ChunkedColumn<uint32_t> generations; // Bumped each time a slot is freed
+    ChunkedColumn<uint32_t> liveTree;    // Fenwick tree of the alive flags, for nthMember
+    std::vector<uint32_t> freeSlots;     // Most recently freed last
+
+    // Returns a slot for a member about to be stored, counted as live
+    size_t newSlot()
+    {
+        if (!freeSlots.empty())
+        {
+            size_t slot = freeSlots.back();
+            freeSlots.pop_back();
+            countLive(slot, true);
+            return slot;
+        }
+        names.push_back({});
+        jobs.push_back(0);
+        hours.push_back(0);
+        contributions.push_back(0);
+        alive.push_back(0);
+        generations.push_back(0);
+        appendLive();
+        return names.size() - 1;
+    }
+    // Adds liveTree's node for a new live slot: itself plus the nodes below it
+    void appendLive()
+    {
+        size_t node = liveTree.size() + 1;
+        uint32_t live = 1;
+        for (size_t step = 1; step < (node & (~node + 1)); step *= 2)
+        {
+            live += liveTree[node - step - 1];
+        }
+        liveTree.push_back(live);
+    }
+    void countLive(size_t slot, bool live)
+    {
+        for (size_t node = slot + 1; node <= liveTree.size(); node += node & (~node + 1))
+        {
+            liveTree[node - 1] = live ? liveTree[node - 1] + 1 : liveTree[node - 1] - 1;
+        }
+    }
+
+public:
+    // Live members
+    size_t size() const
+    {
+        return names.size() - freeSlots.size();
+    }
+    bool empty() const
+    {
+        return size() == 0;
+    }
+    // Live and free slots; valid slots are 0 .. slotCount() - 1
+    size_t slotCount() const
+    {
+        return names.size();
+    }
+    bool isAlive(size_t slot) const
+    {
+        return alive[slot] != 0;
+    }
+    MemberHandle handle(size_t slot) const
+    {
+        return {static_cast<uint32_t>(slot), generations[slot]};
+    }
+    bool isValid(MemberHandle member) const
+    {
+        return member.slot < names.size() && alive[member.slot] && generations[member.slot] == member.generation;
+    }
+    // The slot of the n-th live member in slot order, for n < size(). O(1)
+    // unless some slot is free, then a descent of liveTree in O(log n).
+    size_t nthMember(size_t n) const
+    {
+        if (freeSlots.empty())
+        {
+            return n;
+        }
+        size_t slot = 0, step = 1;
+        while (step * 2 <= liveTree.size())
+        {
+            step *= 2;
+        }
+        for (; step > 0; step /= 2)
+        {
+            if (slot + step <= liveTree.size() && liveTree[slot + step - 1] <= n)
+            {
+                slot += step;
+                n -= liveTree[slot - 1];
+            }
+        }
+        return slot;
+    }
+    // Calls fn(slot) for every live member in slot order
+    template <typename Fn>
+    void forEachMember(Fn fn) const
+    {
+        for (size_t slot = 0; slot < names.size(); ++slot)
+        {
+            if (alive[slot])
+            {
+                fn(slot);
+            }
+        }
+    }
+    void reserve(size_t count)
+    {
+        names.reserve(count);
+        jobs.reserve(count);
+        hours.reserve(count);
+        contributions.reserve(count);
+        alive.reserve(count);
+        generations.reserve(count);
+        liveTree.reserve(count);
+    }
+    // Stores member in a free slot, or a new one, and returns the slot
+    size_t insert(const TeamMember &member)
+    {
+        size_t slot = newSlot();
+        names[slot] = member.getName();
+        jobs[slot] = sharedStrings().intern(member.getJob());
+        hours[slot] = member.getHours();
+        contributions[slot] = member.getContribution();
+        alive[slot] = 1;
+        return slot;
+    }
+    // Appends count members in new slots after the current ones. Strings come
+    // from nameAt(i)/jobAt(i); the numbers are copied from the given columns.
+    template <typename NameAt, typename JobAt>
+    void appendColumns(size_t count, NameAt nameAt, JobAt jobAt, const int *newHours, const double *newContributions)
+    {
+        reserve(slotCount() + count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            names.push_back(std::string(nameAt(i)));
+            jobs.push_back(sharedStrings().intern(jobAt(i)));
+            hours.push_back(newHours[i]);
+            contributions.push_back(newContributions[i]);
+            alive.push_back(1);
+            generations.push_back(0);
+            appendLive();
+        }
+    }
+    // Moves the member in other's slot into a slot of ours and frees theirs.
+    // The name's buffer moves with it; the rest are plain numbers.
+    size_t adopt(TeamStore &other, size_t slot)
+    {
+        size_t adopted = newSlot();
+        names[adopted] = std::move(other.names[slot]);
+        jobs[adopted] = other.jobs[slot];
+        hours[adopted] = other.hours[slot];
+        contributions[adopted] = other.contributions[slot];
+        alive[adopted] = 1;
+        other.erase(slot);
+        return adopted;
+    }
+    void erase(size_t slot)
+    {
+        names[slot] = std::string(); // Releases the name's heap buffer
+        hours[slot] = 0;
+        contributions[slot] = 0;
+        alive[slot] = 0;
+        ++generations[slot];
+        countLive(slot, false);
+        freeSlots.push_back(static_cast<uint32_t>(slot));
+    }
+    const std::string &name(size_t slot) const
+    {
+        return names[slot];
+    }
+    std::string_view job(size_t slot) const
+    {
+        return sharedStrings().get(jobs[slot]);
+    }
+    uint32_t jobId(size_t slot) const
+    {
+        return jobs[slot];
+    }
+    int hoursWorked(size_t slot) const
+    {
+        return hours[slot];
+    }
+    double contribution(size_t slot) const
+    {
+        return contributions[slot];
+    }
+    void setJob(size_t slot, std::string_view newJob)
+    {
+        jobs[slot] = sharedStrings().intern(newJob);
+    }
+    void setHours(size_t slot, int newHours)
+    {
+        hours[slot] = newHours;
+    }
+    void setContribution(size_t slot, double newContribution)
+    {
+        contributions[slot] = newContribution;
+    }
+    double totalContribution() const
+    {
+        double total = 0;
+        contributions.forEachRun([&total](const double *values, size_t length)
+                                 { total += sumContributions(values, length); });
+        return total;
+    }
+    long long totalHours() const
+    {
+        long long total = 0;
+        hours.forEachRun([&total](const int *values, size_t length)
+                         { total += sumHours(values, length); });
+        return total;
+    }
+    // The kernels run block by block while every slot is live. Free slots
+    // would count as zeros in min/max, so with any free slot the live members
+    // are scanned one by one instead.
+    ColumnStats contributionStats() const
+    {
+        return columnStats(contributions, ::contributionStats);
+    }
+    ColumnStats hoursStats() const
+    {
+        return columnStats(hours, ::hoursStats);
+    }
+    // Aggregates the live members in slots first .. last - 1, block by block
+    // through aggregateColumns unless some slot is free
+    TeamAggregate aggregate(size_t first, size_t last) const
+    {
+        TeamAggregate result;
+        while (first < last)
+        {
+            size_t runEnd = std::min(last, (first / ChunkedColumn<int>::blockSize + 1) * ChunkedColumn<int>::blockSize);
+            if (freeSlots.empty())
+            {
+                result.merge(aggregateColumns(&hours[first], &contributions[first], runEnd - first));
+            }
+            else
+            {
+                for (size_t slot = first; slot < runEnd; ++slot)
+                {
+                    if (alive[slot])
+                    {
+                        result.add(hours[slot], contributions[slot]);
+                    }
+                }
+            }
+            first = runEnd;
+        }
+        return result;
+    }
+
+private:
+    template <typename T, typename Kernel>
+    ColumnStats columnStats(const ChunkedColumn<T> &column, Kernel kernel) const
+    {
+        ColumnStats stats;
+        if (empty())
+        {
+            return stats;
+        }
+        stats.min = std::numeric_limits<double>::infinity();
+        stats.max = -std::numeric_limits<double>::infinity();
+        double total = 0;
+        if (freeSlots.empty())
+        {
+            column.forEachRun([&](const T *values, size_t length)
+                              {
+                ColumnStats run = kernel(values, length);
+                stats.min = std::min(stats.min, run.min);
+                stats.max = std::max(stats.max, run.max);
+                total += run.mean * length; });
+        }
+        else
+        {
+            forEachMember([&](size_t slot)
+                          {
+                double value = column[slot];
+                stats.min = std::min(stats.min, value);
+                stats.max = std::max(stats.max, value);
+                total += value; });
+        }
+        stats.mean = total / size();
+        return stats;
+    }
+};
+
+// Ordered index of (key, id) entries that counts and lists the entries with
+// keys in a range in O(log n), plus the entries listed. It is a two-level
+// B-tree: the entries sit in order in sorted blocks of up to maxBlock, a
+// vector of each block's last entry finds the block for a key, and a
+// Fenwick tree over the block sizes turns a position into a rank.
+template <typename Key>
+class RangeIndex
+{
+public:
+    using Entry = std::pair<Key, uint64_t>;
+
+private:
+    static constexpr size_t maxBlock = 1024;
+    std::vector<std::vector<Entry>> blocks; // None empty
+    std::vector<Entry> lasts;               // lasts[b] == blocks[b].back()
+    std::vector<size_t> sizeTree;           // Fenwick tree of block sizes
+    size_t total = 0;
+
+    void rebuildTree()
+    {
+        sizeTree.assign(blocks.size() + 1, 0);
+        for (size_t b = 0; b < blocks.size(); ++b)
+        {
+            for (size_t i = b + 1; i < sizeTree.size(); i += i & (~i + 1))
+            {
+                sizeTree[i] += blocks[b].size();
+            }
+        }
+    }
+    void resizeBlock(size_t b, int delta)
+    {
+        for (size_t i = b + 1; i < sizeTree.size(); i += i & (~i + 1))
+        {
+            sizeTree[i] += delta;
+        }
+        total += delta;
+    }
+    // Entries in blocks before b
+    size_t entriesBefore(size_t b) const
+    {
+        size_t count = 0;
+        for (size_t i = b; i > 0; i -= i & (~i + 1))
+        {
+            count += sizeTree[i];
+        }
+        return count;
+    }
+    // The first block that could hold entry, or blocks.size() if entry is past them all
+    size_t blockFor(const Entry &entry) const
+    {
+        return std::lower_bound(lasts.begin(), lasts.end(), entry) - lasts.begin();
+    }
+    // Entries less than entry
+    size_t rank(const Entry &entry) const
+    {
+        size_t b = blockFor(entry);
+        if (b == blocks.size())
+        {
+            return total;
+        }
+        return entriesBefore(b) + (std::lower_bound(blocks[b].begin(), blocks[b].end(), entry) - blocks[b].begin());
+    }
+
+public:
+    size_t size() const
+    {
+        return total;
+    }
+    // Replaces the contents with entries, in any order
+    void assign(std::vector<Entry> entries)
+    {
+        std::sort(entries.begin(), entries.end());
+        blocks.clear();
+        lasts.clear();
+        for (size_t first = 0; first < entries.size(); first += maxBlock / 2)
+        {
+            auto last = entries.begin() + std::min(entries.size(), first + maxBlock / 2);
+            blocks.emplace_back(entries.begin() + first, last);
+            lasts.push_back(blocks.back().back());
+        }
+        total = entries.size();
+        rebuildTree();
+    }
+    void insert(const Entry &entry)
+    {
+        if (blocks.empty())
+        {
+            assign({entry});
+            return;
+        }
+        size_t b = std::min(blockFor(entry), blocks.size() - 1);
+        std::vector<Entry> &block = blocks[b];
+        block.insert(std::lower_bound(block.begin(), block.end(), entry), entry);
+        lasts[b] = block.back();
+        resizeBlock(b, 1);
+        if (block.size() > maxBlock)
+        {
+            // Split in half; block positions after b shift, so the tree is rebuilt
+            std::vector<Entry> upper(block.begin() + maxBlock / 2, block.end());
+            block.resize(maxBlock / 2);
+            lasts[b] = block.back();
+            lasts.insert(lasts.begin() + b + 1, upper.back());
+            blocks.insert(blocks.begin() + b + 1, std::move(upper));
+            rebuildTree();
+        }
+    }
+    void erase(const Entry &entry)
+    {
+        size_t b = blockFor(entry);
+        if (b == blocks.size())
+        {
+            return;
+        }
+        std::vector<Entry> &block = blocks[b];
+        auto it = std::lower_bound(block.begin(), block.end(), entry);
+        if (it == block.end() || *it != entry)
+        {
+            return;
+        }
+        block.erase(it);
+        resizeBlock(b, -1);
+        if (block.empty())
+        {
+            blocks.erase(blocks.begin() + b);
+            lasts.erase(lasts.begin() + b);
+            rebuildTree();
+        }
+        else
+        {
+            lasts[b] = block.back();
+        }
+    }
+    // Calls fn(entry) for the entries from rank on, smallest first or, if
+    // descending, largest first, until fn returns false. O(log n) to start.
+    template <typename Fn>
+    void forEachFrom(size_t rank, bool descending, Fn fn) const
+    {
+        if (rank >= total)
+        {
+            return;
+        }
+        if (descending)
+        {
+            rank = total - 1 - rank;
+        }
+        // Descends the Fenwick tree to the block holding rank
+        size_t b = 0, step = 1;
+        while (step * 2 <= blocks.size())
+        {
+            step *= 2;
+        }
+        for (; step > 0; step /= 2)
+        {
+            if (b + step <= blocks.size() && sizeTree[b + step] <= rank)
+            {
+                b += step;
+                rank -= sizeTree[b];
+            }
+        }
+        if (descending)
+        {
+            for (size_t i = rank + 1;; i = blocks[b].size())
+            {
+                while (i > 0)
+                {
+                    if (!fn(blocks[b][--i]))
+                    {
+                        return;
+                    }
+                }
+                if (b-- == 0)
+                {
+                    return;
+                }
+            }
+        }
+        for (size_t i = rank; b < blocks.size(); ++b, i = 0)
+        {
+            for (; i < blocks[b].size(); ++i)
+            {
+                if (!fn(blocks[b][i]))
+                {
+                    return;
+                }
+            }
+        }
+    }
+    // Entries with lo <= key <= hi
+    size_t count(Key lo, Key hi) const
+    {
+        if (hi < lo)
+        {
+            return 0;
+        }
+        return rank({hi, UINT64_MAX}) - rank({lo, 0});
+    }
+    // Calls fn(entry) for each entry with lo <= key <= hi, in key order
+    template <typename Fn>
+    void forEach(Key lo, Key hi, Fn fn) const
+    {
+        if (hi < lo)
+        {
+            return;
+        }
+        Entry first{lo, 0}, last{hi, UINT64_MAX};
+        size_t b = blockFor(first);
+        if (b == blocks.size())
+        {
+            return;
+        }
+        auto it = std::lower_bound(blocks[b].begin(), blocks[b].end(), first);
+        while (true)
+        {
+            for (; it != blocks[b].end(); ++it)
+            {
+                if (last < *it)
+                {
+                    return;
+                }
+                fn(*it);
+            }
+            if (++b == blocks.size())
+            {
+                return;
+            }
+            it = blocks[b].begin();
+        }
+    }
+};
+
+// Case-insensitive name search over (name, id) entries: the names that
+// start with a prefix, shortest first, and the names within a few edits of
+// a query, closest first. The names are kept in a compressed trie (a radix
+// tree) whose edges carry runs of characters, so names sharing a prefix
+// share its nodes. Every node knows the shortest name below it, which lets
+// completion visit the trie best-first and stop after k names. The fuzzy
+// lookup carries one row of the edit-distance table per trie character,
+// only the band of it that can still be within the limit, and gives up on a
+// subtree as soon as that band is over the limit.
+// Removed names leave their nodes behind, empty, for the next insert.
+class NameIndex
+{
+public:
+    struct Match
+    {
+        uint64_t id;
+        uint32_t distance; // Edits from the query; 0 for completions
+    };
+
+private:
+    static constexpr uint32_t none = UINT32_MAX;
+    static constexpr uint64_t noId = UINT64_MAX;
+    struct Node
+    {
+        uint64_t id = noId;         // The first entry whose key ends here
+        uint32_t label = 0;         // The edge into the node is labels[label .. label + labelLength)
+        uint32_t labelLength = 0;
+        uint32_t depth = 0;         // Length of the key that ends at the node
+        uint32_t shortest = none;   // Length of the shortest key at or below the node; none if it has no entries
+        uint32_t firstChild = none; // Children in order of their first character
+        uint32_t nextSibling = none;
+        unsigned char first = 0;    // labels[label], kept here so finding a child reads only the siblings
+    };
+    std::vector<Node> nodes = std::vector<Node>(1); // nodes[0] is the root
+    std::vector<char> labels;
+    std::unordered_multimap<uint32_t, uint64_t> moreIds; // The other entries for keys held more than once
+    size_t entryCount = 0;
+
+    static std::string fold(std::string_view name)
+    {
+        std::string key(name);
+        for (char &c : key)
+        {
+            if (c >= 'A' && c <= 'Z')
+            {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+        }
+        return key;
+    }
+    // The child of node whose label starts with c, or none; previous is the
+    // sibling before where such a child would go
+    uint32_t findChild(uint32_t node, char c, uint32_t &previous) const
+    {
+        unsigned char wanted = static_cast<unsigned char>(c);
+        previous = none;
+        uint32_t child = nodes[node].firstChild;
+        while (child != none && nodes[child].first < wanted)
+        {
+            previous = child;
+            child = nodes[child].nextSibling;
+        }
+        return child != none && nodes[child].first == wanted ? child : none;
+    }
+    void link(uint32_t parent, uint32_t previous, uint32_t child)
+    {
+        (previous == none ? nodes[parent].firstChild : nodes[previous].nextSibling) = child;
+    }
+    // The node whose key is exactly key, or none; path gets the nodes on the way
+    uint32_t find(const std::string &key, std::vector<uint32_t> &path) const
+    {
+        uint32_t node = 0;
+        for (size_t i = 0; i < key.size();)
+        {
+            uint32_t previous;
+            node = findChild(node, key[i], previous);
+            if (node == none || nodes[node].labelLength > key.size() - i ||
+                key.compare(i, nodes[node].labelLength, &labels[nodes[node].label], nodes[node].labelLength) != 0)
+            {
+                return none;
+            }
+            i += nodes[node].labelLength;
+            path.push_back(node);
+        }
+        return node;
+    }
+    // The ids of the entries whose key ends at node, smallest first
+    void idsAt(uint32_t node, std::vector<uint64_t> &ids) const
+    {
+        ids.clear();
+        if (nodes[node].id != noId)
+        {
+            ids.push_back(nodes[node].id);
+        }
+        auto [from, to] = moreIds.equal_range(node);
+        for (; from != to; ++from)
+        {
+            ids.push_back(from->second);
+        }
+        std::sort(ids.begin(), ids.end());
+    }
+
+    // Renumbers the nodes breadth first, so that each node's children sit
+    // side by side and a search reads them in one sweep
+    void layOut()
+    {
+        std::vector<uint32_t> order{0};
+        for (size_t head = 0; head < order.size(); ++head)
+        {
+            for (uint32_t child = nodes[order[head]].firstChild; child != none; child = nodes[child].nextSibling)
+            {
+                order.push_back(child);
+            }
+        }
+        std::vector<uint32_t> renumbered(nodes.size());
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            renumbered[order[i]] = static_cast<uint32_t>(i);
+        }
+
+        std::vector<Node> laidOut(order.size());
+        std::vector<char> laidOutLabels;
+        laidOutLabels.reserve(labels.size());
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            const Node &old = nodes[order[i]];
+            Node &node = laidOut[i] = old;
+            node.label = static_cast<uint32_t>(laidOutLabels.size());
+            laidOutLabels.insert(laidOutLabels.end(), labels.begin() + old.label, labels.begin() + old.label + old.labelLength);
+            node.firstChild = old.firstChild == none ? none : renumbered[old.firstChild];
+            node.nextSibling = old.nextSibling == none ? none : renumbered[old.nextSibling];
+        }
+        std::unordered_multimap<uint32_t, uint64_t> laidOutIds;
+        for (const auto &[node, id] : moreIds)
+        {
+            laidOutIds.emplace(renumbered[node], id);
+        }
+        nodes = std::move(laidOut);
+        labels = std::move(laidOutLabels);
+        moreIds = std::move(laidOutIds);
+    }
+    void insertKey(const std::string &key, uint64_t id)
+    {
+        uint32_t length = static_cast<uint32_t>(key.size());
+        uint32_t node = 0;
+        nodes[0].shortest = std::min(nodes[0].shortest, length);
+        for (size_t i = 0; i < key.size();)
+        {
+            uint32_t previous;
+            uint32_t child = findChild(node, key[i], previous);
+            if (child == none)
+            {
+                // A new leaf holds the rest of the key
+                child = static_cast<uint32_t>(nodes.size());
+                nodes.emplace_back();
+                Node &leaf = nodes[child];
+                leaf.label = static_cast<uint32_t>(labels.size());
+                leaf.labelLength = length - static_cast<uint32_t>(i);
+                leaf.depth = length;
+                leaf.nextSibling = previous == none ? nodes[node].firstChild : nodes[previous].nextSibling;
+                leaf.first = static_cast<unsigned char>(key[i]);
+                labels.insert(labels.end(), key.begin() + i, key.end());
+                link(node, previous, child);
+            }
+            size_t common = 1;
+            while (common < nodes[child].labelLength && i + common < key.size() &&
+                   labels[nodes[child].label + common] == key[i + common])
+            {
+                ++common;
+            }
+            if (common < nodes[child].labelLength)
+            {
+                // The key leaves the edge part way: split it at that point
+                uint32_t middle = static_cast<uint32_t>(nodes.size());
+                nodes.emplace_back();
+                Node &split = nodes[middle], &rest = nodes[child];
+                split.label = rest.label;
+                split.labelLength = static_cast<uint32_t>(common);
+                split.depth = rest.depth - rest.labelLength + static_cast<uint32_t>(common);
+                split.shortest = rest.shortest;
+                split.firstChild = child;
+                split.nextSibling = rest.nextSibling;
+                split.first = rest.first;
+                rest.label += static_cast<uint32_t>(common);
+                rest.labelLength -= static_cast<uint32_t>(common);
+                rest.nextSibling = none;
+                rest.first = static_cast<unsigned char>(labels[rest.label]);
+                link(node, previous, middle);
+                child = middle;
+            }
+            node = child;
+            nodes[node].shortest = std::min(nodes[node].shortest, length);
+            i += common;
+        }
+        if (nodes[node].id == noId)
+        {
+            nodes[node].id = id;
+        }
+        else
+        {
+            moreIds.emplace(node, id);
+        }
+        ++entryCount;
+    }
+
+public:
+    size_t size() const
+    {
+        return entryCount;
+    }
+    void insert(std::string_view name, uint64_t id)
+    {
+        insertKey(fold(name), id);
+    }
+    // Replaces the contents with entries, in any order. Much faster than
+    // inserting them one by one, and lays the trie out for fast searches.
+    void assign(std::vector<std::pair<std::string, uint64_t>> entries)
+    {
+        for (auto &entry : entries)
+        {
+            entry.first = fold(entry.first);
+        }
+        std::sort(entries.begin(), entries.end()); // In order, each insert follows the last one's path
+        *this = NameIndex();
+        for (const auto &[key, id] : entries)
+        {
+            insertKey(key, id);
+        }
+        layOut();
+    }
+    // False if there is no such entry
+    bool erase(std::string_view name, uint64_t id)
+    {
+        std::vector<uint32_t> path{0};
+        uint32_t node = find(fold(name), path);
+        if (node == none)
+        {
+            return false;
+        }
+        auto [from, to] = moreIds.equal_range(node);
+        if (nodes[node].id == id)
+        {
+            nodes[node].id = from == to ? noId : from->second;
+        }
+        else
+        {
+            while (from != to && from->second != id)
+            {
+                ++from;
+            }
+            if (from == to)
+            {
+                return false;
+            }
+        }
+        if (from != to)
+        {
+            moreIds.erase(from);
+        }
+        --entryCount;
+        // Only the nodes on the path can have lost their shortest key
+        for (auto step = path.rbegin(); step != path.rend(); ++step)
+        {
+            Node &current = nodes[*step];
+            current.shortest = current.id == noId ? none : current.depth;
+            for (uint32_t child = current.firstChild; child != none; child = nodes[child].nextSibling)
+            {
+                current.shortest = std::min(current.shortest, nodes[child].shortest);
+            }
+        }
+        return true;
+    }
+    // Up to k entries whose names start with prefix, shortest name first,
+    // then in alphabetical order
+    std::vector<Match> complete(std::string_view prefix, size_t k) const
+    {
+        std::vector<Match> matches;
+        std::string key = fold(prefix);
+        std::string start; // The key of node, which may run past the prefix
+        uint32_t node = 0;
+        for (size_t i = 0; i < key.size(); i += nodes[node].labelLength)
+        {
+            uint32_t previous;
+            node = findChild(node, key[i], previous);
+            size_t length = node == none ? 0 : std::min<size_t>(nodes[node].labelLength, key.size() - i);
+            if (node == none || key.compare(i, length, &labels[nodes[node].label], length) != 0)
+            {
+                return matches;
+            }
+            start.append(&labels[nodes[node].label], nodes[node].labelLength);
+        }
+        if (nodes[node].shortest == none)
+        {
+            return matches;
+        }
+
+        // Frontier nodes never hold each other's keys, so ordering them by
+        // (shortest key below, key) hands out their keys in (length, key) order
+        struct Frontier
+        {
+            uint32_t shortest;
+            std::string key;
+            uint32_t node;
+            bool operator>(const Frontier &other) const
+            {
+                return shortest != other.shortest ? shortest > other.shortest : key > other.key;
+            }
+        };
+        std::priority_queue<Frontier, std::vector<Frontier>, std::greater<Frontier>> frontier;
+        frontier.push({nodes[node].shortest, std::move(start), node});
+        std::vector<uint64_t> ids;
+        while (!frontier.empty() && matches.size() < k)
+        {
+            Frontier next = frontier.top();
+            frontier.pop();
+            idsAt(next.node, ids);
+            for (size_t i = 0; i < ids.size() && matches.size() < k; ++i)
+            {
+                matches.push_back({ids[i], 0});
+            }
+            for (uint32_t child = nodes[next.node].firstChild; child != none; child = nodes[child].nextSibling)
+            {
+                if (nodes[child].shortest != none)
+                {
+                    frontier.push({nodes[child].shortest,
+                                   next.key + std::string(&labels[nodes[child].label], nodes[child].labelLength), child});
+                }
+            }
+        }
+        return matches;
+    }
+    // Up to k entries whose names are at most maxDistance edits from name,
+    // where an edit inserts, deletes or replaces one character or swaps two
+    // adjacent ones. Fewest edits first, then names closest in length, then
+    // in alphabetical order.
+    std::vector<Match> similar(std::string_view name, uint32_t maxDistance, size_t k) const
+    {
+        std::string key = fold(name);
+        size_t width = key.size() + 1;
+        uint32_t over = maxDistance + 1; // Every distance past the limit is stored as this
+        // rows[t * width ..] is the edit-distance row after the t-th character
+        // on the current path, which is path[t - 1]. Row t only needs the
+        // columns within maxDistance of t; the rest are over.
+        std::vector<uint32_t> rows(width);
+        std::string path;
+        for (size_t q = 0; q < width; ++q)
+        {
+            rows[q] = std::min(static_cast<uint32_t>(q), over);
+        }
+
+        struct Found
+        {
+            uint32_t distance;
+            uint32_t lengthGap;
+            uint32_t order; // Visit order, which is alphabetical
+            uint32_t node;
+        };
+        std::vector<Found> found;
+        if (nodes[0].id != noId && key.size() <= maxDistance)
+        {
+            found.push_back({static_cast<uint32_t>(key.size()), static_cast<uint32_t>(key.size()), 0, 0});
+        }
+        std::vector<uint32_t> stack;
+        auto pushChildren = [&](uint32_t node)
+        {
+            size_t mark = stack.size();
+            for (uint32_t child = nodes[node].firstChild; child != none; child = nodes[child].nextSibling)
+            {
+                if (nodes[child].shortest != none)
+                {
+                    stack.push_back(child);
+                }
+            }
+            std::reverse(stack.begin() + mark, stack.end()); // First child on top
+        };
+        pushChildren(0);
+        uint32_t order = 1;
+        while (!stack.empty())
+        {
+            uint32_t node = stack.back();
+            stack.pop_back();
+            const Node &current = nodes[node];
+            if (current.shortest > key.size() + maxDistance)
+            {
+                continue; // Every name below is too long
+            }
+            rows.resize(std::max(rows.size(), (current.depth + 1) * width));
+            path.resize(current.depth);
+            uint32_t best = 0;
+            size_t t = current.depth - current.labelLength + 1; // The row for the label's first character
+            for (uint32_t j = 0; j < current.labelLength; ++j, ++t)
+            {
+                if (t > key.size() + maxDistance)
+                {
+                    best = over; // Too many characters past the end of name
+                    break;
+                }
+                char c = labels[current.label + j];
+                path[t - 1] = c;
+                const uint32_t *above = &rows[(t - 1) * width];
+                uint32_t *row = &rows[t * width];
+                size_t lo = t > maxDistance ? t - maxDistance : 1;
+                size_t hi = std::min(key.size(), t + maxDistance);
+                row[lo - 1] = std::min(static_cast<uint32_t>(t), over);
+                best = row[lo - 1];
+                for (size_t q = lo; q <= hi; ++q)
+                {
+                    uint32_t cost = std::min({above[q] + 1, row[q - 1] + 1, above[q - 1] + (key[q - 1] != c)});
+                    if (q > 1 && t > 1 && key[q - 1] == path[t - 2] && key[q - 2] == c)
+                    {
+                        cost = std::min(cost, rows[(t - 2) * width + q - 2] + 1);
+                    }
+                    row[q] = std::min(cost, over);
+                    best = std::min(best, row[q]);
+                }
+                if (hi + 1 < width)
+                {
+                    row[hi + 1] = over; // Read by the next row
+                }
+                if (best > maxDistance)
+                {
+                    break; // Every name below is too far off as well
+                }
+            }
+            if (best > maxDistance)
+            {
+                continue;
+            }
+            uint32_t distance = current.depth + maxDistance >= key.size() ? rows[current.depth * width + key.size()] : over;
+            if (current.id != noId && distance <= maxDistance)
+            {
+                uint32_t gap = current.depth > key.size() ? static_cast<uint32_t>(current.depth - key.size())
+                                                          : static_cast<uint32_t>(key.size() - current.depth);
+                found.push_back({distance, gap, order, node});
+            }
+            ++order;
+            pushChildren(node);
+        }
+
+        auto ranked = [](const Found &a, const Found &b)
+        {
+            return std::tie(a.distance, a.lengthGap, a.order) < std::tie(b.distance, b.lengthGap, b.order);
+        };
+        size_t keep = std::min(found.size(), k);
+        std::partial_sort(found.begin(), found.begin() + keep, found.end(), ranked);
+        std::vector<Match> matches;
+        std::vector<uint64_t> ids;
+        for (size_t i = 0; i < keep && matches.size() < k; ++i)
+        {
+            idsAt(found[i].node, ids);
+            for (size_t j = 0; j < ids.size() && matches.size() < k; ++j)
+            {
+                matches.push_back({ids[j], found[i].distance});
+            }
+        }
+        return matches;
+    }
+};
+
+// One org mutation as it is written to the write-ahead log
+enum class MutationType : uint8_t
+{
+    AddCTO = 1,
+    AddMember = 2,
+    ModifyMember = 3,
+    RemoveMember = 4,
+    ModifyExactMember = 5, // Through a handle: the member with these old values
+    RemoveExactMember = 6,
+    TransferBatch = 7,  // hours is the number of TransferMember records that follow
+    TransferMember = 8  // Exact member of cto, moving to the CTO at targetPosition
+};
+
+struct MutationRecord
+{
+    uint64_t sequence = 0;
+    MutationType type = MutationType::AddCTO;
+    std::string_view cto;
+    std::string_view member;
+    std::string_view detail; // The job, the field for AddCTO or the new CTO for TransferMember
+    int32_t hours = 0;
+    double contribution = 0;
+    // Only for the Exact types and TransferMember: the member's values before
+    // the change. Members with the same name and values are interchangeable,
+    // so these pick out the member a handle referred to. The slot is tried first, which keeps replays
+    // from the same starting state in the same slots.
+    std::string_view oldJob = {};
+    int32_t oldHours = 0;
+    double oldContribution = 0;
+    uint32_t slot = 0;
+    // Where the CTO is in ctoList, which its name does not pin down once two
+    // CTOs share it. CTOs are never removed, so replay finds it there again.
+    uint32_t position = 0;
+    uint32_t targetPosition = 0; // TransferMember's new CTO
+};
+
+// A small work-stealing thread pool. Each worker owns a deque of tasks: it
+// takes work from the back of its own and, once that is empty, steals from
+// the front of the others', so one long task does not leave the rest idle.
+class WorkStealingPool
+{
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues; // Queue 0 belongs to the thread calling run
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    size_t queued = 0; // Tasks in any queue; guarded by sleepMutex
+    bool stopping = false;
+
+    bool takeTask(size_t self, std::function<void()> &task)
+    {
+        for (size_t i = 0; i < queues.size(); ++i)
+        {
+            Queue &queue = *queues[(self + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                if (i == 0)
+                {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                }
+                else
+                {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                std::lock_guard<std::mutex> count(sleepMutex);
+                --queued;
+                return true;
+            }
+        }
+        return false;
+    }
+    void workerLoop(size_t self)
+    {
+        std::function<void()> task;
+        while (true)
+        {
+            if (takeTask(self, task))
+            {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this]
+                      { return stopping || queued > 0; });
+            if (stopping)
+            {
+                return;
+            }
+        }
+    }
+
+public:
+    // threadCount counts the caller of run, so 1 runs everything inline
+    explicit WorkStealingPool(unsigned threadCount)
+    {
+        threadCount = std::max(threadCount, 1u);
+        for (unsigned i = 0; i < threadCount; ++i)
+        {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (unsigned i = 1; i < threadCount; ++i)
+        {
+            workers.emplace_back([this, i]
+                                 { workerLoop(i); });
+        }
+    }
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+    size_t threadCount() const
+    {
+        return queues.size();
+    }
+    // Runs every task, dealt round-robin onto the queues, and returns once all
+    // have finished. The calling thread works through them too.
+    void run(std::vector<std::function<void()>> tasks)
+    {
+        std::atomic<size_t> remaining{tasks.size()};
+        for (size_t i = 0; i < tasks.size(); ++i)
+        {
+            Queue &queue = *queues[i % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back([&remaining, task = std::move(tasks[i])]
+                                  {
+                task();
+                remaining.fetch_sub(1, std::memory_order_release); });
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queued += tasks.size();
+        }
+        wake.notify_all();
+        std::function<void()> task;
+        while (takeTask(0, task))
+        {
+            task();
+        }
+        while (remaining.load(std::memory_order_acquire) != 0)
+        {
+            std::this_thread::yield(); // The last tasks are running on workers
+        }
+    }
+};
+
+// Orders (contribution, index) pairs highest contribution first; ties go to
+// the lower index: the CTO added first, as std::max_element used to pick, or
+// the older member slot
+struct RankOrder
+{
+    bool operator()(const std::pair<double, size_t> &a, const std::pair<double, size_t> &b) const
+    {
+        if (a.first != b.first)
+        {
+            return a.first > b.first;
+        }
+        return a.second < b.second;
+    }
+};
+
+class CEO;
+class CTO;
+
+// One member and its CTO, as ranking and filter queries return them. The CTO
+// pointer lasts until the next addCTO.
+struct MemberRow
+{
+    const CTO *cto;
+    MemberHandle handle;
+    TeamMember member;
+};
+
+// One result of a name search: a CTO, with member left invalid, or one of its members
+struct NameMatch
+{
+    const CTO *cto;
+    MemberHandle member;
+    std::string name;
+    uint32_t distance; // Edits from the name searched for; 0 for completions
+};
+
+// Class for CTOs
+class CTO : public Employee<CTO>
+{
+    friend class CEO;
+    friend class OrgTree;
+
+    uint32_t fieldId; // In sharedStrings()
+    TeamStore team;
+    double totalContribution = 0; // Kept up to date by every team mutation
+    CEO *owner = nullptr;         // Set by CEO::addCTO so the leaderboard can follow our total
+    size_t position = 0;          // Our position in the owner's ctoList
+    // Member name -> slots in team, in slot order: the order the team is
+    // shown in, which a rebuild from the team keeps. Names may repeat.
+    std::unordered_map<std::string, std::vector<size_t>> memberIndex;
+    bool memberIndexReady = true; // False after a snapshot load until a lookup needs it
+    // The best (contribution, slot) pairs of the team in RankOrder: always
+    // exactly its top topMembers.size() members, at most topCapacity of them.
+    // Removals can shrink it; getTopMembers rebuilds it when a query needs more.
+    std::set<std::pair<double, size_t>, RankOrder> topMembers;
+    size_t topCapacity = 128;
+    std::vector<uint32_t> jobPosting; // Slot -> its entry in the owner's job index, once that is built
+    // The team's (hours, slot) and (contribution, slot) entries in order, for
+    // CEO::writePage's sorted pages of one CTO. Built by the first such page,
+    // then kept up by indexMember/unindexMember.
+    RangeIndex<int> hoursRanks;
+    RangeIndex<double> contributionRanks;
+    bool rankIndexesReady = false;
+
+    void ensureMemberIndex()
+    {
+        if (memberIndexReady)
+        {
+            return;
+        }
+        memberIndex.clear();
+        team.forEachMember([this](size_t slot)
+                           { memberIndex[team.name(slot)].push_back(slot); });
+        memberIndexReady = true;
+    }
+    void ensureRankIndexes()
+    {
+        if (rankIndexesReady)
+        {
+            return;
+        }
+        std::vector<RangeIndex<int>::Entry> hours;
+        std::vector<RangeIndex<double>::Entry> contributions;
+        hours.reserve(team.size());
+        contributions.reserve(team.size());
+        team.forEachMember([&](size_t slot)
+                           {
+            hours.push_back({team.hoursWorked(slot), slot});
+            contributions.push_back({team.contribution(slot), slot}); });
+        hoursRanks.assign(std::move(hours));
+        contributionRanks.assign(std::move(contributions));
+        rankIndexesReady = true;
+    }
+
+    // Defined after CEO, which they call into. notifyChanged tells the owner
+    // the team changed, so it can rerank us and republish us to readers;
+    // resized tells it how many members the team gained (or lost, if delta
+    // is negative); indexMember/unindexMember keep our rank indexes and its
+    // member indexes in step with slot, and indexName/unindexName its name
+    // search as members come and go.
+    void notifyChanged(double oldTotal);
+    void resized(ptrdiff_t delta);
+    void indexMember(size_t slot);
+    void unindexMember(size_t slot);
+    void indexName(size_t slot);
+    void unindexName(size_t slot);
+    void logMutation(MutationRecord record);
+
+    // Puts slot's entry into topMembers if it belongs there. Members outside
+    // the set rank below its last entry, so a member can join by beating that
+    // entry, by having ranked at or above floor (the last entry before it left
+    // the set), or when everyone else is already in.
+    void rankMember(size_t slot, const std::pair<double, size_t> *floor = nullptr)
+    {
+        std::pair<double, size_t> entry{team.contribution(slot), slot};
+        RankOrder before;
+        bool joins = topMembers.size() + 1 == team.size() || (floor && !before(*floor, entry)) ||
+                     (!topMembers.empty() && before(entry, *topMembers.rbegin()));
+        if (joins)
+        {
+            insertRanked(entry);
+        }
+    }
+    void insertRanked(const std::pair<double, size_t> &entry)
+    {
+        topMembers.insert(entry);
+        if (topMembers.size() > topCapacity)
+        {
+            topMembers.erase(std::prev(topMembers.end()));
+        }
+    }
+    // Trims entries to its best count, unordered
+    static void keepBest(std::vector<std::pair<double, size_t>> &entries, size_t count)
+    {
+        if (entries.size() > count)
+        {
+            std::nth_element(entries.begin(), entries.begin() + count, entries.end(), RankOrder());
+            entries.resize(count);
+        }
+    }
+    // Refills topMembers from every live member: each range of slots keeps
+    // its own best topCapacity, on pool's threads if given, and the best of
+    // those are kept
+    void rebuildTopMembers(WorkStealingPool *pool)
+    {
+        const size_t grain = size_t(1) << 16;
+        size_t ranges = (team.slotCount() + grain - 1) / grain;
+        std::vector<std::vector<std::pair<double, size_t>>> best(ranges);
+        auto collect = [this, &best, grain](size_t range)
+        {
+            auto &entries = best[range];
+            size_t last = std::min(team.slotCount(), (range + 1) * grain);
+            for (size_t slot = range * grain; slot < last; ++slot)
+            {
+                if (team.isAlive(slot))
+                {
+                    entries.push_back({team.contribution(slot), slot});
+                }
+            }
+            keepBest(entries, topCapacity);
+        };
+        if (pool && ranges > 1)
+        {
+            std::vector<std::function<void()>> tasks;
+            for (size_t range = 0; range < ranges; ++range)
+            {
+                tasks.push_back([&collect, range]
+                                { collect(range); });
+            }
+            pool->run(std::move(tasks));
+        }
+        else
+        {
+            for (size_t range = 0; range < ranges; ++range)
+            {
+                collect(range);
+            }
+        }
+        std::vector<std::pair<double, size_t>> merged;
+        for (const auto &entries : best)
+        {
+            merged.insert(merged.end(), entries.begin(), entries.end());
+        }
+        keepBest(merged, topCapacity);
+        topMembers = std::set<std::pair<double, size_t>, RankOrder>(merged.begin(), merged.end());
+    }
+    // Makes sure topMembers holds the top k, or the whole team if smaller
+    void ensureTopMembers(size_t k, WorkStealingPool *pool)
+    {
+        k = std::min(k, team.size());
+        if (topMembers.size() < k)
+        {
+            topCapacity = std::max(topCapacity, k);
+            rebuildTopMembers(pool);
+        }
+    }
+    MemberRow memberRow(size_t slot) const
+    {
+        return {this, team.handle(slot),
+                TeamMember(team.name(slot), std::string(team.job(slot)), team.hoursWorked(slot), team.contribution(slot))};
+    }
+    void updateSlot(size_t slot, std::string_view newJob, int newHours, double newContribution)
+    {
+        double oldTotal = totalContribution;
+        double oldContribution = team.contribution(slot);
+        totalContribution += newContribution - oldContribution;
+        bool changed = team.job(slot) != newJob || team.hoursWorked(slot) != newHours || oldContribution != newContribution;
+        if (changed)
+        {
+            unindexMember(slot);
+        }
+        team.setJob(slot, newJob);
+        team.setHours(slot, newHours);
+        team.setContribution(slot, newContribution);
+        if (changed)
+        {
+            indexMember(slot);
+        }
+        if (newContribution != oldContribution)
+        {
+            std::pair<double, size_t> floor;
+            bool ranked = !topMembers.empty() && (floor = *topMembers.rbegin(), topMembers.erase({oldContribution, slot}) != 0);
+            rankMember(slot, ranked ? &floor : nullptr);
+        }
+        notifyChanged(oldTotal);
+    }
+    // Puts slot into memberIndex, if that is built
+    void listName(size_t slot)
+    {
+        if (!memberIndexReady)
+        {
+            return;
+        }
+        auto &slots = memberIndex[team.name(slot)];
+        slots.insert(std::lower_bound(slots.begin(), slots.end(), slot), slot);
+    }
+    // Takes slot out of memberIndex, if that is built
+    void unlistName(size_t slot)
+    {
+        if (!memberIndexReady)
+        {
+            return;
+        }
+        auto it = memberIndex.find(team.name(slot));
+        auto &slots = it->second;
+        slots.erase(std::find(slots.begin(), slots.end(), slot));
+        if (slots.empty())
+        {
+            memberIndex.erase(it);
+        }
+    }
+    // Frees slot; the caller keeps the name index in step
+    void eraseSlot(size_t slot)
+    {
+        topMembers.erase({team.contribution(slot), slot});
+        unindexMember(slot);
+        unindexName(slot);
+        totalContribution -= team.contribution(slot);
+        team.erase(slot);
+        resized(-1);
+        if (team.empty())
+        {
+            totalContribution = 0; // Drop any rounding left over from the subtractions
+        }
+    }
+    // Moves the member at slot into target's team for CEO::transferMembers
+    // and returns its slot there. Both teams' rankings, name indexes, totals
+    // and the owner's member indexes follow; notifyChanged is left to the caller.
+    size_t moveSlotTo(CTO &target, size_t slot)
+    {
+        double contribution = team.contribution(slot);
+        topMembers.erase({contribution, slot});
+        unindexMember(slot);
+        unindexName(slot);
+        unlistName(slot);
+        totalContribution -= contribution;
+        size_t moved = target.team.adopt(team, slot);
+        resized(-1);
+        target.resized(1);
+        if (team.empty())
+        {
+            totalContribution = 0; // Drop any rounding left over from the subtractions
+        }
+        target.totalContribution += contribution;
+        target.listName(moved);
+        target.rankMember(moved);
+        target.indexMember(moved);
+        target.indexName(moved);
+        return moved;
+    }
+    // The old-values half of an Exact log record for the member at slot
+    MutationRecord exactRecord(MutationType type, size_t slot) const
+    {
+        MutationRecord record;
+        record.type = type;
+        record.member = team.name(slot);
+        record.oldJob = team.job(slot);
+        record.oldHours = team.hoursWorked(slot);
+        record.oldContribution = team.contribution(slot);
+        record.slot = static_cast<uint32_t>(slot);
+        return record;
+    }
+
+    // For snapshotCopy: the team and totals without an owner or name index
+    CTO(const CTO &other, const TeamStore &members)
+        : fieldId(other.fieldId), team(members), totalContribution(other.totalContribution), memberIndexReady(false)
+    {
+        name = other.name;
+    }
+    // An unowned copy of this CTO for an OrgSnapshot
+    std::shared_ptr<const CTO> snapshotCopy() const
+    {
+        return std::shared_ptr<const CTO>(new CTO(*this, team));
+    }
+
+public:
+    CTO(std::string n, std::string_view f) : fieldId(sharedStrings().intern(f))
+    {
+        name = std::move(n);
+    }
+    void addTeamMember(const TeamMember &member)
+    {
+        addNewMember(member);
+    }
+    void writeReport(ReportWriter &report) const
+    {
+        report.text("CTO: ").text(name).text(" - Field: ").text(getField()).endRow();
+        report.column("Name", 15).column("Job", 20).column("Hours", 10).column("Contribution", 15).endRow();
+        report.repeat('-', 60).endRow();
+        team.forEachMember([&](size_t slot)
+                           { TeamMember::writeRow(report, team.name(slot), team.job(slot), team.hoursWorked(slot), team.contribution(slot)); });
+    }
+    std::string_view getField() const
+    {
+        return sharedStrings().get(fieldId);
+    }
+    // Job titles are interned, so this is one hash lookup and then integer compares
+    size_t countMembersWithJob(std::string_view job) const
+    {
+        uint32_t id = sharedStrings().find(job);
+        size_t count = 0;
+        if (id != StringPool::none)
+        {
+            team.forEachMember([&](size_t slot)
+                               { count += team.jobId(slot) == id; });
+        }
+        return count;
+    }
+    double getTotalContribution() const
+    {
+        return totalContribution;
+    }
+    long long getTotalHours() const
+    {
+        return team.totalHours();
+    }
+    ColumnStats getContributionStats() const
+    {
+        return team.contributionStats();
+    }
+    ColumnStats getHoursStats() const
+    {
+        return team.hoursStats();
+    }
+    // The k members with the highest contribution, best first; ties go to
+    // the older slot. Served from the ranking kept up by every mutation; the
+    // team is only scanned (on pool's threads if given) when removals or a
+    // snapshot load have left that ranking short of k.
+    std::vector<MemberRow> getTopMembers(size_t k, WorkStealingPool *pool = nullptr)
+    {
+        ensureTopMembers(k, pool);
+        std::vector<MemberRow> ranking;
+        for (auto it = topMembers.begin(); it != topMembers.end() && ranking.size() < k; ++it)
+        {
+            ranking.push_back(memberRow(it->second));
+        }
+        return ranking;
+    }
+    MemberHandle addNewMember(const TeamMember &member)
+    {
+        double oldTotal = totalContribution;
+        size_t slot = team.insert(member);
+        resized(1);
+        listName(slot);
+        totalContribution += member.getContribution();
+        rankMember(slot);
+        indexMember(slot);
+        indexName(slot);
+        notifyChanged(oldTotal);
+        logMutation({0, MutationType::AddMember, {}, member.getName(), member.getJob(), member.getHours(), member.getContribution()});
+        return team.handle(slot);
+    }
+    // The first member with this name in slot order, or an invalid handle
+    MemberHandle findMember(const std::string &memberName)
+    {
+        ensureMemberIndex();
+        auto it = memberIndex.find(memberName);
+        return it == memberIndex.end() ? MemberHandle() : team.handle(it->second.front());
+    }
+    bool isValid(MemberHandle member) const
+    {
+        return team.isValid(member);
+    }
+    void reserveMembers(size_t count)
+    {
+        team.reserve(team.slotCount() + count);
+    }
+    // Appends count members in one go from columns; nameAt(i)/jobAt(i) give
+    // the strings. The name index is rebuilt lazily instead of per member.
+    template <typename NameAt, typename JobAt>
+    void addNewMembers(size_t count, NameAt nameAt, JobAt jobAt, const int *hours, const double *contributions)
+    {
+        double oldTotal = totalContribution;
+        size_t first = team.slotCount();
+        team.appendColumns(count, nameAt, jobAt, hours, contributions);
+        resized(static_cast<ptrdiff_t>(count));
+        memberIndex.clear();
+        memberIndexReady = false;
+        totalContribution += sumContributions(contributions, count);
+        // rankMember's rule, judged against topMembers as it was before the append
+        bool everyoneIn = topMembers.size() + count == team.size();
+        bool hasFloor = !topMembers.empty();
+        std::pair<double, size_t> floor = hasFloor ? *topMembers.rbegin() : std::pair<double, size_t>();
+        for (size_t slot = first; slot < team.slotCount(); ++slot)
+        {
+            std::pair<double, size_t> entry{team.contribution(slot), slot};
+            if (everyoneIn || (hasFloor && RankOrder()(entry, floor)))
+            {
+                insertRanked(entry);
+            }
+            indexMember(slot);
+            indexName(slot);
+        }
+        notifyChanged(oldTotal);
+        for (size_t slot = first; slot < team.slotCount(); ++slot)
+        {
+            logMutation({0, MutationType::AddMember, {}, team.name(slot), team.job(slot), team.hoursWorked(slot), team.contribution(slot)});
+        }
+    }
+    // With duplicate names only the first in slot order is modified
+    bool modifyTeamMember(const std::string &memberName, const std::string &newJob, int newHours, double newContribution)
+    {
+        ensureMemberIndex();
+        auto it = memberIndex.find(memberName);
+        if (it == memberIndex.end())
+        {
+            return false;
+        }
+        updateSlot(it->second.front(), newJob, newHours, newContribution);
+        logMutation({0, MutationType::ModifyMember, {}, memberName, newJob, newHours, newContribution});
+        return true;
+    }
+    // Modifies exactly the member the handle refers to; false if it is stale
+    bool modifyTeamMember(MemberHandle member, const std::string &newJob, int newHours, double newContribution)
+    {
+        if (!team.isValid(member))
+        {
+            return false;
+        }
+        MutationRecord record = exactRecord(MutationType::ModifyExactMember, member.slot);
+        record.detail = newJob;
+        record.hours = newHours;
+        record.contribution = newContribution;
+        logMutation(record); // Before the update, while the old job is still the one in the record
+        updateSlot(member.slot, newJob, newHours, newContribution);
+        return true;
+    }
+    // With duplicate names every member of that name is removed; returns how many were
+    size_t removeTeamMember(const std::string &memberName)
+    {
+        ensureMemberIndex();
+        auto it = memberIndex.find(memberName);
+        if (it == memberIndex.end())
+        {
+            return 0;
+        }
+        std::vector<size_t> slots = std::move(it->second);
+        memberIndex.erase(it);
+        double oldTotal = totalContribution;
+        for (size_t slot : slots)
+        {
+            eraseSlot(slot);
+        }
+        notifyChanged(oldTotal);
+        logMutation({0, MutationType::RemoveMember, {}, memberName, {}});
+        return slots.size();
+    }
+    // Removes exactly the member the handle refers to, even among duplicates
+    bool removeTeamMember(MemberHandle member)
+    {
+        if (!team.isValid(member))
+        {
+            return false;
+        }
+        logMutation(exactRecord(MutationType::RemoveExactMember, member.slot));
+        unlistName(member.slot);
+        double oldTotal = totalContribution;
+        eraseSlot(member.slot);
+        notifyChanged(oldTotal);
+        return true;
+    }
+    // Finds the member with this name and these values, for replaying Exact
+    // log records: the one in slotHint if it matches, else any of them
+    MemberHandle findExactMember(const std::string &memberName, std::string_view job, int hours, double contribution,
+                                 size_t slotHint)
+    {
+        auto matches = [&](size_t slot)
+        {
+            return team.name(slot) == memberName && team.job(slot) == job && team.hoursWorked(slot) == hours &&
+                   team.contribution(slot) == contribution;
+        };
+        if (slotHint < team.slotCount() && team.isAlive(slotHint) && matches(slotHint))
+        {
+            return team.handle(slotHint);
+        }
+        ensureMemberIndex();
+        auto it = memberIndex.find(memberName);
+        if (it != memberIndex.end())
+        {
+            for (size_t slot : it->second)
+            {
+                if (matches(slot))
+                {
+                    return team.handle(slot);
+                }
+            }
+        }
+        return MemberHandle();
+    }
+};
+
+// Binary snapshot of a whole organization. Every section starts on an 8-byte
+// boundary and uses native byte order:
+//   SnapshotHeader
+//   SnapshotCTO ctos[ctoCount]       (members firstMember .. firstMember + memberCount - 1)
+//   SnapshotString names[memberCount]
+//   SnapshotString jobs[memberCount]
+//   int32_t hours[memberCount]       (padded to 8 bytes)
+//   double contributions[memberCount]
+//   char strings[stringBytes]        (every string above, back to back)
+const char snapshotMagic[8] = {'E', 'M', 'S', 'S', 'N', 'A', 'P', '\0'};
+const uint32_t snapshotVersion = 1;
+const uint32_t snapshotByteOrder = 0x01020304; // Reads back differently on a foreign-endian machine
+
+struct SnapshotString
+{
+    uint64_t offset; // Into the string table
+    uint64_t length;
+};
+
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    SnapshotString ceoName;
+    uint64_t ctoCount;
+    uint64_t memberCount;
+    uint64_t stringBytes;
+    uint64_t logSequence; // Last write-ahead log record folded into this snapshot
+};
+
+struct SnapshotCTO
+{
+    SnapshotString name;
+    SnapshotString field;
+    uint64_t firstMember;
+    uint64_t memberCount;
+};
+
+inline size_t alignTo8(size_t bytes)
+{
+    return (bytes + 7) & ~size_t(7);
+}
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+    const char *bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+public:
+    explicit MappedFile(const std::string &path)
+    {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER fileSize;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            return;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+        {
+            bytes = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            length = bytes ? static_cast<size_t>(fileSize.QuadPart) : 0;
+        }
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                bytes = static_cast<const char *>(mapped);
+                length = info.st_size;
+            }
+        }
+        close(fd); // The mapping stays valid without the descriptor
+#endif
+    }
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (bytes)
+        {
+            UnmapViewOfFile(bytes);
+        }
+        if (mapping)
+        {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(file);
+        }
+#else
+        if (bytes)
+        {
+            munmap(const_cast<char *>(bytes), length);
+        }
+#endif
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    const char *data() const
+    {
+        return bytes;
+    }
+    size_t size() const
+    {
+        return length;
+    }
+};
+
+// Append-only log of org mutations. Records are buffered and written with a
+// single fsync once groupCommit of them are pending (group commit), or when
+// commit() is called. A crash loses at most the records not yet committed.
+//
+// Each record is: uint32 payload length, uint32 FNV-1a checksum of the
+// payload, then the payload: uint64 sequence, uint8 type, three strings
+// (uint32 length + bytes), int32 hours and a double contribution. The Exact
+// types add the old job, hours and contribution in the same encoding, then
+// a uint32 slot.
+class WriteAheadLog
+{
+    std::string path;
+    std::FILE *file = nullptr;
+    std::string pending; // Encoded records waiting for the next commit
+    size_t pendingRecords = 0;
+    size_t groupCommit;
+    size_t syncCount = 0;
+
+    template <typename T>
+    static void put(std::string &out, T value)
+    {
+        out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    static void putString(std::string &out, std::string_view text)
+    {
+        put(out, static_cast<uint32_t>(text.size()));
+        out.append(text);
+    }
+    template <typename T>
+    static bool get(const char *&p, const char *end, T &value)
+    {
+        if (static_cast<size_t>(end - p) < sizeof(value))
+        {
+            return false;
+        }
+        std::memcpy(&value, p, sizeof(value));
+        p += sizeof(value);
+        return true;
+    }
+    static bool getString(const char *&p, const char *end, std::string_view &text)
+    {
+        uint32_t length;
+        if (!get(p, end, length) || static_cast<size_t>(end - p) < length)
+        {
+            return false;
+        }
+        text = std::string_view(p, length);
+        p += length;
+        return true;
+    }
+
+    static bool hasOldValues(MutationType type)
+    {
+        return type == MutationType::ModifyExactMember || type == MutationType::RemoveExactMember ||
+               type == MutationType::TransferMember;
+    }
+
+public:
+    static uint32_t checksum(const char *data, size_t length)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+        }
+        return hash;
+    }
+
+    WriteAheadLog(std::string logPath, size_t groupCommitRecords)
+        : path(std::move(logPath)), groupCommit(std::max<size_t>(groupCommitRecords, 1)) {}
+    ~WriteAheadLog()
+    {
+        close();
+    }
+    WriteAheadLog(const WriteAheadLog &) = delete;
+    WriteAheadLog &operator=(const WriteAheadLog &) = delete;
+
+    // Calls apply(record) for every intact record in the log, in order. A torn
+    // or corrupt tail left by a crash is cut off so new records follow the
+    // last good one; a transfer batch is only applied if all of it is intact.
+    // Returns false if the log exists but cannot be repaired.
+    template <typename Apply>
+    bool replay(Apply apply)
+    {
+        size_t goodBytes = 0;
+        {
+            MappedFile mapped(path);
+            const char *p = mapped.data();
+            const char *end = p + mapped.size();
+            std::vector<MutationRecord> batch; // A transfer batch read so far
+            while (p)
+            {
+                uint32_t length, sum;
+                MutationRecord r;
+                uint8_t type;
+                if (!get(p, end, length) || !get(p, end, sum) || static_cast<size_t>(end - p) < length ||
+                    checksum(p, length) != sum)
+                {
+                    break;
+                }
+                const char *payloadEnd = p + length;
+                if (!get(p, payloadEnd, r.sequence) || !get(p, payloadEnd, type) || !getString(p, payloadEnd, r.cto) ||
+                    !getString(p, payloadEnd, r.member) || !getString(p, payloadEnd, r.detail) ||
+                    !get(p, payloadEnd, r.hours) || !get(p, payloadEnd, r.contribution))
+                {
+                    break;
+                }
+                r.type = static_cast<MutationType>(type);
+                if (hasOldValues(r.type) &&
+                    (!getString(p, payloadEnd, r.oldJob) || !get(p, payloadEnd, r.oldHours) ||
+                     !get(p, payloadEnd, r.oldContribution) || !get(p, payloadEnd, r.slot)))
+                {
+                    break;
+                }
+                if (!get(p, payloadEnd, r.position) || !get(p, payloadEnd, r.targetPosition))
+                {
+                    break;
+                }
+                p = payloadEnd;
+                if (r.type == MutationType::TransferBatch || !batch.empty())
+                {
+                    batch.push_back(r);
+                    if (batch.size() <= static_cast<size_t>(batch.front().hours))
+                    {
+                        continue; // Not all of the batch yet
+                    }
+                    for (const MutationRecord &record : batch)
+                    {
+                        apply(record);
+                    }
+                    batch.clear();
+                }
+                else
+                {
+                    apply(r);
+                }
+                goodBytes = p - mapped.data();
+            }
+        }
+        std::error_code error;
+        if (std::filesystem::exists(path, error) && std::filesystem::file_size(path, error) != goodBytes)
+        {
+            std::filesystem::resize_file(path, goodBytes, error);
+            return !error;
+        }
+        return true;
+    }
+    bool open()
+    {
+        file = std::fopen(path.c_str(), "ab");
+        return file != nullptr;
+    }
+    void append(const MutationRecord &record)
+    {
+        std::string payload;
+        put(payload, record.sequence);
+        put(payload, static_cast<uint8_t>(record.type));
+        putString(payload, record.cto);
+        putString(payload, record.member);
+        putString(payload, record.detail);
+        put(payload, record.hours);
+        put(payload, record.contribution);
+        if (hasOldValues(record.type))
+        {
+            putString(payload, record.oldJob);
+            put(payload, record.oldHours);
+            put(payload, record.oldContribution);
+            put(payload, record.slot);
+        }
+        put(payload, record.position);
+        put(payload, record.targetPosition);
+        put(pending, static_cast<uint32_t>(payload.size()));
+        put(pending, checksum(payload.data(), payload.size()));
+        pending += payload;
+        if (++pendingRecords >= groupCommit)
+        {
+            commit();
+        }
+    }
+    // Writes every pending record and waits for them to reach the disk
+    bool commit()
+    {
+        if (!file || pendingRecords == 0)
+        {
+            return true;
+        }
+        bool ok = std::fwrite(pending.data(), 1, pending.size(), file) == pending.size() && std::fflush(file) == 0;
+#ifdef _WIN32
+        ok = ok && _commit(_fileno(file)) == 0;
+#else
+        ok = ok && fsync(fileno(file)) == 0;
+#endif
+        pending.clear();
+        pendingRecords = 0;
+        ++syncCount;
+        return ok;
+    }
+    // Drops every record, once they are all folded into a snapshot
+    bool truncate()
+    {
+        commit();
+        if (file)
+        {
+            std::fclose(file);
+        }
+        file = std::fopen(path.c_str(), "wb");
+        return file != nullptr;
+    }
+    void close()
+    {
+        if (file)
+        {
+            commit();
+            std::fclose(file);
+            file = nullptr;
+        }
+    }
+    size_t getSyncCount() const
+    {
+        return syncCount;
+    }
+};
+
+// CEO::aggregate's result: one aggregate per CTO, in ctoList order, and the org's as a whole
+struct OrgAggregate
+{
+    std::vector<TeamAggregate> ctos;
+    TeamAggregate org;
+};
+
+// An immutable copy of the organization as of one CEO::publishSnapshot.
+// CTOs that did not change between two publishes are shared by both
+// snapshots, so publishing only copies the CTOs that were edited.
+class OrgSnapshot
+{
+    friend class CEO;
+
+    std::string ceoName;
+    std::vector<std::shared_ptr<const CTO>> ctos; // In the CEO's ctoList order
+    const CTO *topCTO = nullptr;                  // Highest total contribution when published
+
+public:
+    // Same output as CEO::writeReport at the time of the publish
+    void writeReport(ReportWriter &report) const
+    {
+        report.text("CEO: ").text(ceoName).endRow();
+        for (const auto &cto : ctos)
+        {
+            cto->writeReport(report);
+            report.endRow();
+        }
+    }
+    void determineTopCTO(ReportWriter &report) const
+    {
+        if (!topCTO)
+        {
+            report.text("No CTOs available to determine the top contributor.").endRow();
+            return;
+        }
+        report.endRow();
+        report.text("The CTO whose team contributed the most is: ").text(topCTO->getName());
+        report.text(" with a total contribution of ").column(topCTO->getTotalContribution(), 0).text(".").endRow();
+    }
+    // nullptr if there were no CTOs
+    const CTO *getTopCTO() const
+    {
+        return topCTO;
+    }
+    size_t ctoCount() const
+    {
+        return ctos.size();
+    }
+    const CTO &getCTO(size_t position) const
+    {
+        return *ctos[position];
+    }
+};
+
+class SnapshotReader;
+
+// Hands the latest OrgSnapshot to reader threads without locks, RCU style.
+// Each reader owns a slot in which it announces the publish epoch it started
+// reading in. A snapshot replaced by a newer one is freed by the writer once
+// no reader is still in an epoch up to the one it was replaced in.
+class SnapshotDomain
+{
+    friend class SnapshotReader;
+
+public:
+    static constexpr size_t maxReaders = 64;
+
+private:
+    std::atomic<const OrgSnapshot *> current;
+    std::atomic<uint64_t> epoch{1};
+    std::array<std::atomic<uint64_t>, maxReaders> readerEpochs{}; // 0 while not reading
+    std::array<std::atomic<bool>, maxReaders> slotTaken{};
+    // Writer only: replaced snapshots and the epoch each was replaced in
+    std::vector<std::pair<uint64_t, std::unique_ptr<const OrgSnapshot>>> retired;
+
+public:
+    SnapshotDomain() : current(new OrgSnapshot()) {}
+    SnapshotDomain(const SnapshotDomain &) = delete;
+    SnapshotDomain &operator=(const SnapshotDomain &) = delete;
+    // Every reader must be gone by now
+    ~SnapshotDomain()
+    {
+        delete current.load();
+    }
+    // Writer only: the snapshot published last
+    const OrgSnapshot &latest() const
+    {
+        return *current.load(std::memory_order_relaxed);
+    }
+    // Writer only: makes next the snapshot readers get from now on
+    void publish(std::unique_ptr<const OrgSnapshot> next)
+    {
+        const OrgSnapshot *replaced = current.exchange(next.release());
+        retired.emplace_back(epoch.fetch_add(1), replaced);
+        reclaim();
+    }
+    // Writer only: frees the replaced snapshots no reader can still hold.
+    // A reader that announced epoch e loaded the current pointer after the
+    // epoch moved to e, so it only holds snapshots replaced in e or later.
+    void reclaim()
+    {
+        uint64_t oldest = UINT64_MAX;
+        for (const auto &reader : readerEpochs)
+        {
+            uint64_t announced = reader.load();
+            if (announced != 0)
+            {
+                oldest = std::min(oldest, announced);
+            }
+        }
+        retired.erase(std::remove_if(retired.begin(), retired.end(),
+                                     [oldest](const auto &entry)
+                                     { return entry.first < oldest; }),
+                      retired.end());
+    }
+    // nullptr if maxReaders readers are already open
+    std::unique_ptr<SnapshotReader> openReader();
+};
+
+// One reader thread's access to a SnapshotDomain. Not for sharing between threads.
+class SnapshotReader
+{
+    friend class SnapshotDomain;
+
+    SnapshotDomain &domain;
+    size_t slot;
+
+    SnapshotReader(SnapshotDomain &d, size_t s) : domain(d), slot(s) {}
+
+public:
+    SnapshotReader(const SnapshotReader &) = delete;
+    SnapshotReader &operator=(const SnapshotReader &) = delete;
+    ~SnapshotReader()
+    {
+        done();
+        domain.slotTaken[slot].store(false, std::memory_order_release);
+    }
+    // The latest published snapshot. It stays valid until the next read or
+    // done, so hold the reference no longer than one report.
+    const OrgSnapshot &read()
+    {
+        domain.readerEpochs[slot].store(domain.epoch.load());
+        return *domain.current.load();
+    }
+    // Lets the writer free the snapshot from the last read
+    void done()
+    {
+        domain.readerEpochs[slot].store(0, std::memory_order_release);
+    }
+};
+
+std::unique_ptr<SnapshotReader> SnapshotDomain::openReader()
+{
+    for (size_t slot = 0; slot < maxReaders; ++slot)
+    {
+        bool taken = false;
+        if (slotTaken[slot].compare_exchange_strong(taken, true))
+        {
+            return std::unique_ptr<SnapshotReader>(new SnapshotReader(*this, slot));
+        }
+    }
+    return nullptr;
+}
+
+// One page of members for CEO::writePage: rows offset .. offset + pageSize - 1
+// in the given order, across the org or within one CTO
+struct PageRequest
+{
+    enum class Order
+    {
+        Storage, // CTOs in the order added, members in slot order, as displayInfo shows them
+        Hours,
+        Contribution
+    };
+    size_t pageSize = 50;
+    size_t offset = 0;
+    std::string cto; // Empty for every CTO
+    Order order = Order::Storage;
+    bool descending = false; // For Hours and Contribution
+};
+
+// Handle to a CTO of one CEO. CTOs are never removed one by one, so a handle
+// stays valid until the whole org is replaced by a snapshot load, which moves
+// the CEO to a new epoch. Unlike a CTO pointer it survives later addCTO calls.
+struct CTOHandle
+{
+    uint32_t position = UINT32_MAX;
+    uint32_t epoch = 0;
+};
+
+// One move in a CEO::transferMembers batch
+struct MemberTransfer
+{
+    CTOHandle from;
+    MemberHandle member; // In from's team
+    CTOHandle to;
+};
+
+// Class for CEO
+class CEO : public Employee<CEO>
+{
+    friend class CTO;
+    friend class OrgTree;
+
+    std::vector<CTO> ctoList;
+    std::unordered_map<std::string, size_t> ctoIndex; // CTO name -> position in ctoList
+    std::set<std::pair<double, size_t>, RankOrder> leaderboard;
+    uint32_t epoch = 0;                 // Bumped whenever ctoList is replaced
+    std::unique_ptr<WriteAheadLog> log; // Set by openLog
+    uint64_t logSequence = 0;           // Sequence number of the last mutation applied
+    SnapshotDomain snapshots;
+    std::vector<bool> snapshotStale; // By position: changed since the last publishSnapshot
+    // Org-wide member indexes, built by the first query that needs one and
+    // then kept up by the CTO mutations. Members are named by
+    // (position << 32 | slot). jobPostings maps a job ID to its members in no
+    // particular order; a CTO's jobPosting finds a member's entry for removal.
+    std::vector<std::vector<uint64_t>> jobPostings;
+    RangeIndex<int> hoursIndex;
+    RangeIndex<double> contributionIndex;
+    bool memberIndexesReady = false;
+    // Every CTO and member name for completeName and findSimilarNames, built
+    // by the first search. Members are named as above; a CTO is
+    // (position << 32 | ctoSlot).
+    NameIndex nameIndex;
+    bool nameIndexReady = false;
+    static constexpr uint32_t ctoSlot = UINT32_MAX;
+    std::vector<MutationRecord> pendingTransfers; // The replayed transfer batch so far
+    size_t pendingTransferCount = 0;
+    // Members in the org, and a Fenwick tree of team sizes by position so a
+    // page in storage order finds the CTO holding a row in O(log CTOs)
+    size_t memberCount = 0;
+    std::vector<size_t> teamSizeTree;
+
+    void resizeTeam(size_t position, ptrdiff_t delta)
+    {
+        for (size_t i = position + 1; i < teamSizeTree.size(); i += i & (~i + 1))
+        {
+            teamSizeTree[i] += delta;
+        }
+        memberCount += delta;
+    }
+    // Adds the node for the CTO at position, the next one: its team plus the nodes below it
+    void appendTeamSize(size_t position)
+    {
+        size_t i = position + 1, size = ctoList[position].team.size();
+        for (size_t step = 1; step < (i & (~i + 1)); step *= 2)
+        {
+            size += teamSizeTree[i - step];
+        }
+        teamSizeTree.push_back(size);
+        memberCount += ctoList[position].team.size();
+    }
+    // The position of the CTO holding the row-th member in storage order,
+    // for row < memberCount, and in row the member's rank in that team
+    size_t ctoHoldingRow(size_t &row) const
+    {
+        size_t position = 0, step = 1;
+        while (step * 2 < teamSizeTree.size())
+        {
+            step *= 2;
+        }
+        for (; step > 0; step /= 2)
+        {
+            if (position + step < teamSizeTree.size() && teamSizeTree[position + step] <= row)
+            {
+                position += step;
+                row -= teamSizeTree[position];
+            }
+        }
+        return position;
+    }
+
+    void recordMutation(MutationRecord record)
+    {
+        record.sequence = ++logSequence;
+        if (log)
+        {
+            log->append(record);
+        }
+    }
+    // The CTO at a replayed record's position, if there is one
+    CTOHandle loggedCTO(uint32_t position) const
+    {
+        return position < ctoList.size() ? CTOHandle{position, epoch} : CTOHandle();
+    }
+    // Applies one replayed log record; records already in the snapshot are skipped
+    void applyMutation(const MutationRecord &record)
+    {
+        if (record.sequence <= logSequence)
+        {
+            return;
+        }
+        if (record.type == MutationType::TransferBatch)
+        {
+            pendingTransfers.clear();
+            pendingTransferCount = static_cast<size_t>(record.hours);
+        }
+        else if (record.type == MutationType::TransferMember)
+        {
+            // Replay hands over whole batches only; resolve and move them together
+            pendingTransfers.push_back(record);
+            if (pendingTransfers.size() == pendingTransferCount)
+            {
+                std::vector<MemberTransfer> moves;
+                for (const MutationRecord &move : pendingTransfers)
+                {
+                    CTOHandle from = loggedCTO(move.position);
+                    CTO *source = getCTO(from);
+                    MemberHandle member = source ? source->findExactMember(std::string(move.member), move.oldJob, move.oldHours,
+                                                                           move.oldContribution, move.slot)
+                                                 : MemberHandle();
+                    moves.push_back({from, member, loggedCTO(move.targetPosition)});
+                }
+                pendingTransfers.clear();
+                transferMembers(moves);
+                logSequence = record.sequence;
+            }
+            return;
+        }
+        else if (record.type == MutationType::AddCTO)
+        {
+            addCTO(CTO(std::string(record.cto), record.detail));
+        }
+        else if (CTO *cto = getCTO(loggedCTO(record.position)))
+        {
+            if (record.type == MutationType::AddMember)
+            {
+                cto->addNewMember(TeamMember(std::string(record.member), std::string(record.detail), record.hours, record.contribution));
+            }
+            else if (record.type == MutationType::ModifyMember)
+            {
+                cto->modifyTeamMember(std::string(record.member), std::string(record.detail), record.hours, record.contribution);
+            }
+            else if (record.type == MutationType::RemoveMember)
+            {
+                cto->removeTeamMember(std::string(record.member));
+            }
+            else
+            {
+                MemberHandle member = cto->findExactMember(std::string(record.member), record.oldJob, record.oldHours,
+                                                            record.oldContribution, record.slot);
+                if (record.type == MutationType::ModifyExactMember)
+                {
+                    cto->modifyTeamMember(member, std::string(record.detail), record.hours, record.contribution);
+                }
+                else if (record.type == MutationType::RemoveExactMember)
+                {
+                    cto->removeTeamMember(member);
+                }
+            }
+        }
+        logSequence = record.sequence;
+    }
+
+    void postJob(size_t position, size_t slot)
+    {
+        CTO &cto = ctoList[position];
+        uint32_t job = cto.team.jobId(slot);
+        if (job >= jobPostings.size())
+        {
+            jobPostings.resize(job + 1); // Job IDs are dense
+        }
+        if (slot >= cto.jobPosting.size())
+        {
+            cto.jobPosting.resize(slot + 1);
+        }
+        cto.jobPosting[slot] = static_cast<uint32_t>(jobPostings[job].size());
+        jobPostings[job].push_back(uint64_t(position) << 32 | slot);
+    }
+    // Swaps the last entry of the job's list into the removed member's place
+    void unpostJob(size_t position, size_t slot)
+    {
+        CTO &cto = ctoList[position];
+        std::vector<uint64_t> &postings = jobPostings[cto.team.jobId(slot)];
+        uint32_t index = cto.jobPosting[slot];
+        uint64_t moved = postings.back();
+        postings[index] = moved;
+        ctoList[moved >> 32].jobPosting[static_cast<uint32_t>(moved)] = index;
+        postings.pop_back();
+    }
+    void postMember(size_t position, size_t slot)
+    {
+        const TeamStore &team = ctoList[position].team;
+        postJob(position, slot);
+        hoursIndex.insert({team.hoursWorked(slot), uint64_t(position) << 32 | slot});
+        contributionIndex.insert({team.contribution(slot), uint64_t(position) << 32 | slot});
+    }
+    void unpostMember(size_t position, size_t slot)
+    {
+        const TeamStore &team = ctoList[position].team;
+        unpostJob(position, slot);
+        hoursIndex.erase({team.hoursWorked(slot), uint64_t(position) << 32 | slot});
+        contributionIndex.erase({team.contribution(slot), uint64_t(position) << 32 | slot});
+    }
+    void ensureMemberIndexes()
+    {
+        if (memberIndexesReady)
+        {
+            return;
+        }
+        jobPostings.clear();
+        std::vector<RangeIndex<int>::Entry> hours;
+        std::vector<RangeIndex<double>::Entry> contributions;
+        for (size_t position = 0; position < ctoList.size(); ++position)
+        {
+            const TeamStore &team = ctoList[position].team;
+            team.forEachMember([&](size_t slot)
+                               {
+                postJob(position, slot);
+                hours.push_back({team.hoursWorked(slot), uint64_t(position) << 32 | slot});
+                contributions.push_back({team.contribution(slot), uint64_t(position) << 32 | slot}); });
+        }
+        hoursIndex.assign(std::move(hours));
+        contributionIndex.assign(std::move(contributions));
+        memberIndexesReady = true;
+    }
+    // The postings for job, or nullptr if nobody has that job
+    const std::vector<uint64_t> *jobPostingsFor(std::string_view job)
+    {
+        ensureMemberIndexes();
+        uint32_t id = sharedStrings().find(job);
+        return id < jobPostings.size() ? &jobPostings[id] : nullptr;
+    }
+
+    void ensureNameIndex()
+    {
+        if (nameIndexReady)
+        {
+            return;
+        }
+        std::vector<std::pair<std::string, uint64_t>> entries;
+        for (size_t position = 0; position < ctoList.size(); ++position)
+        {
+            const CTO &cto = ctoList[position];
+            entries.emplace_back(cto.getName(), uint64_t(position) << 32 | ctoSlot);
+            cto.team.forEachMember([&](size_t slot)
+                                   { entries.emplace_back(cto.team.name(slot), uint64_t(position) << 32 | slot); });
+        }
+        nameIndex.assign(std::move(entries));
+        nameIndexReady = true;
+    }
+    std::vector<NameMatch> nameMatches(const std::vector<NameIndex::Match> &matches) const
+    {
+        std::vector<NameMatch> results;
+        results.reserve(matches.size());
+        for (const NameIndex::Match &match : matches)
+        {
+            const CTO &cto = ctoList[match.id >> 32];
+            uint32_t slot = static_cast<uint32_t>(match.id);
+            if (slot == ctoSlot)
+            {
+                results.push_back({&cto, MemberHandle(), cto.getName(), match.distance});
+            }
+            else
+            {
+                results.push_back({&cto, cto.team.handle(slot), cto.team.name(slot), match.distance});
+            }
+        }
+        return results;
+    }
+
+    void updateRanking(size_t position, double oldTotal, double newTotal)
+    {
+        leaderboard.erase({oldTotal, position});
+        leaderboard.insert({newTotal, position});
+    }
+
+public:
+    CEO(std::string n) : teamSizeTree(1)
+    {
+        name = n;
+        publishSnapshot();
+    }
+    CTOHandle addCTO(CTO cto)
+    {
+        // The first CTO added under a name keeps it, like the old linear scan did
+        ctoIndex.emplace(cto.getName(), ctoList.size());
+        ctoList.push_back(std::move(cto));
+        CTO &added = ctoList.back();
+        added.owner = this;
+        added.position = ctoList.size() - 1;
+        appendTeamSize(added.position);
+        leaderboard.insert({added.getTotalContribution(), added.position});
+        snapshotStale.push_back(true);
+        if (memberIndexesReady)
+        {
+            added.team.forEachMember([&](size_t slot)
+                                     { postMember(added.position, slot); });
+        }
+        if (nameIndexReady)
+        {
+            nameIndex.insert(added.getName(), uint64_t(added.position) << 32 | ctoSlot);
+            added.team.forEachMember([&](size_t slot)
+                                     { nameIndex.insert(added.team.name(slot), uint64_t(added.position) << 32 | slot); });
+        }
+        recordMutation({0, MutationType::AddCTO, added.getName(), {}, added.getField()});
+        added.team.forEachMember([&](size_t slot)
+                                 { added.logMutation({0, MutationType::AddMember, {}, added.team.name(slot), added.team.job(slot),
+                                                      added.team.hoursWorked(slot), added.team.contribution(slot)}); });
+        return {static_cast<uint32_t>(added.position), epoch};
+    }
+    void writeReport(ReportWriter &report) const
+    {
+        report.text("CEO: ").text(name).endRow();
+        for (const auto &cto : ctoList)
+        {
+            cto.writeReport(report);
+            report.endRow();
+        }
+    }
+    CTO *getCTO(const std::string &ctoName)
+    {
+        auto it = ctoIndex.find(ctoName);
+        if (it == ctoIndex.end())
+        {
+            return nullptr;
+        }
+        return &ctoList[it->second];
+    }
+    // Looks the name up once; keep the handle to skip the lookup next time
+    CTOHandle findCTO(const std::string &ctoName) const
+    {
+        auto it = ctoIndex.find(ctoName);
+        return it == ctoIndex.end() ? CTOHandle() : CTOHandle{static_cast<uint32_t>(it->second), epoch};
+    }
+    // O(1); nullptr if the handle is from before a snapshot load. The pointer
+    // itself, unlike the handle, only lasts until the next addCTO.
+    CTO *getCTO(CTOHandle cto)
+    {
+        if (cto.epoch != epoch || cto.position >= ctoList.size())
+        {
+            return nullptr;
+        }
+        return &ctoList[cto.position];
+    }
+    // Moves every member in moves to its new CTO as one step: the member's
+    // row is relocated, so jobs, hours and contributions go along unchanged.
+    // Nothing moves unless every handle is current, every member is listed
+    // once and no move stays within one CTO. Each CTO's total, leaderboard
+    // place and snapshot are updated once for the whole batch, which is
+    // logged as a unit. moved, if given, gets the members' new handles.
+    bool transferMembers(const std::vector<MemberTransfer> &moves, std::vector<MemberHandle> *moved = nullptr)
+    {
+        std::unordered_set<uint64_t> listed;
+        for (const MemberTransfer &move : moves)
+        {
+            CTO *source = getCTO(move.from);
+            if (!source || !getCTO(move.to) || move.from.position == move.to.position || !source->isValid(move.member) ||
+                !listed.insert(uint64_t(move.from.position) << 32 | move.member.slot).second)
+            {
+                return false;
+            }
+        }
+
+        recordMutation({0, MutationType::TransferBatch, {}, {}, {}, static_cast<int>(moves.size())});
+        for (const MemberTransfer &move : moves)
+        {
+            const CTO &source = ctoList[move.from.position];
+            MutationRecord record = source.exactRecord(MutationType::TransferMember, move.member.slot);
+            record.cto = source.getName();
+            record.detail = ctoList[move.to.position].getName();
+            record.position = move.from.position;
+            record.targetPosition = move.to.position;
+            recordMutation(record);
+        }
+
+        std::unordered_map<size_t, double> oldTotals; // Position -> total before the batch
+        if (moved)
+        {
+            moved->clear();
+        }
+        for (const MemberTransfer &move : moves)
+        {
+            CTO &source = ctoList[move.from.position];
+            CTO &target = ctoList[move.to.position];
+            oldTotals.emplace(move.from.position, source.totalContribution);
+            oldTotals.emplace(move.to.position, target.totalContribution);
+            size_t slot = source.moveSlotTo(target, move.member.slot);
+            if (moved)
+            {
+                moved->push_back(target.team.handle(slot));
+            }
+        }
+        for (const auto &[position, oldTotal] : oldTotals)
+        {
+            ctoList[position].notifyChanged(oldTotal);
+        }
+        return true;
+    }
+    // Prints the CTO with the highest total from the leaderboard. The CEO's
+    // name is left alone: this used to rename the CEO after the winner too.
+    void determineTopCTO() const
+    {
+        if (ctoList.empty())
+        {
+            std::cout << "No CTOs available to determine the top contributor.\n";
+            return;
+        }
+
+        const CTO *topCTO = &ctoList[leaderboard.begin()->second];
+
+        std::cout << "\nThe CTO whose team contributed the most is: " << topCTO->getName()
+                  << " with a total contribution of " << topCTO->getTotalContribution() << ".\n";
+    }
+    // Writes the whole organization to path as a binary snapshot. The file is
+    // written next to path first and renamed over it once complete.
+    bool saveSnapshot(const std::string &path) const
+    {
+        std::string strings;
+        auto addString = [&strings](std::string_view text)
+        {
+            SnapshotString ref{strings.size(), text.size()};
+            strings += text;
+            return ref;
+        };
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+        header.version = snapshotVersion;
+        header.byteOrder = snapshotByteOrder;
+        header.ceoName = addString(name);
+        header.ctoCount = ctoList.size();
+
+        std::vector<SnapshotCTO> ctos;
+        ctos.reserve(ctoList.size());
+        for (const auto &cto : ctoList)
+        {
+            ctos.push_back({addString(cto.getName()), addString(cto.getField()), header.memberCount, cto.team.size()});
+            header.memberCount += cto.team.size();
+        }
+
+        std::vector<SnapshotString> names, jobs;
+        // Each interned job title goes into the string table once
+        std::vector<SnapshotString> jobStrings(sharedStrings().size(), {0, UINT64_MAX});
+        std::vector<int32_t> hours;
+        std::vector<double> contributions;
+        names.reserve(header.memberCount);
+        jobs.reserve(header.memberCount);
+        hours.reserve(header.memberCount + 1);
+        contributions.reserve(header.memberCount);
+        for (const auto &cto : ctoList)
+        {
+            cto.team.forEachMember([&](size_t slot)
+                                   {
+                names.push_back(addString(cto.team.name(slot)));
+                SnapshotString &job = jobStrings[cto.team.jobId(slot)];
+                if (job.length == UINT64_MAX)
+                {
+                    job = addString(cto.team.job(slot));
+                }
+                jobs.push_back(job);
+                hours.push_back(cto.team.hoursWorked(slot));
+                contributions.push_back(cto.team.contribution(slot)); });
+        }
+        if (hours.size() % 2)
+        {
+            hours.push_back(0); // Pads the hours column to 8 bytes
+        }
+        header.stringBytes = strings.size();
+        header.logSequence = logSequence;
+
+        std::string tempPath = path + ".tmp";
+        std::FILE *out = std::fopen(tempPath.c_str(), "wb");
+        if (!out)
+        {
+            return false;
+        }
+        bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1 &&
+                  std::fwrite(ctos.data(), sizeof(SnapshotCTO), ctos.size(), out) == ctos.size() &&
+                  std::fwrite(names.data(), sizeof(SnapshotString), names.size(), out) == names.size() &&
+                  std::fwrite(jobs.data(), sizeof(SnapshotString), jobs.size(), out) == jobs.size() &&
+                  std::fwrite(hours.data(), sizeof(int32_t), hours.size(), out) == hours.size() &&
+                  std::fwrite(contributions.data(), sizeof(double), contributions.size(), out) == contributions.size() &&
+                  std::fwrite(strings.data(), 1, strings.size(), out) == strings.size();
+        ok = (std::fclose(out) == 0) && ok;
+        if (ok && std::rename(tempPath.c_str(), path.c_str()) != 0)
+        {
+            // Windows will not rename over an existing file
+            std::remove(path.c_str());
+            ok = std::rename(tempPath.c_str(), path.c_str()) == 0;
+        }
+        if (!ok)
+        {
+            std::remove(tempPath.c_str());
+        }
+        return ok;
+    }
+    // Replaces the whole organization with the snapshot at path. The file is
+    // mapped and its columns copied in directly; on any error nothing changes.
+    // Refused once a log is open, since the log only follows the current org.
+    bool loadSnapshot(const std::string &path)
+    {
+        if (log)
+        {
+            return false;
+        }
+        MappedFile file(path);
+        if (!file.data() || file.size() < sizeof(SnapshotHeader))
+        {
+            return false;
+        }
+        SnapshotHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0 ||
+            header.version != snapshotVersion || header.byteOrder != snapshotByteOrder)
+        {
+            return false;
+        }
+
+        // Checks the section sizes against the file before touching any of them
+        uint64_t members = header.memberCount;
+        uint64_t limit = file.size();
+        if (header.ctoCount > limit / sizeof(SnapshotCTO) || members > limit / (2 * sizeof(SnapshotString)))
+        {
+            return false;
+        }
+        size_t ctoOffset = sizeof(SnapshotHeader);
+        size_t namesOffset = ctoOffset + header.ctoCount * sizeof(SnapshotCTO);
+        size_t jobsOffset = namesOffset + members * sizeof(SnapshotString);
+        size_t hoursOffset = jobsOffset + members * sizeof(SnapshotString);
+        size_t contributionsOffset = hoursOffset + alignTo8(members * sizeof(int32_t));
+        size_t stringsOffset = contributionsOffset + members * sizeof(double);
+        if (stringsOffset > limit || header.stringBytes != limit - stringsOffset)
+        {
+            return false;
+        }
+
+        const auto *ctos = reinterpret_cast<const SnapshotCTO *>(file.data() + ctoOffset);
+        const auto *names = reinterpret_cast<const SnapshotString *>(file.data() + namesOffset);
+        const auto *jobs = reinterpret_cast<const SnapshotString *>(file.data() + jobsOffset);
+        const auto *hours = reinterpret_cast<const int32_t *>(file.data() + hoursOffset);
+        const auto *contributions = reinterpret_cast<const double *>(file.data() + contributionsOffset);
+        const char *strings = file.data() + stringsOffset;
+        auto valid = [&header](const SnapshotString &ref)
+        {
+            return ref.offset <= header.stringBytes && ref.length <= header.stringBytes - ref.offset;
+        };
+        auto view = [strings](const SnapshotString &ref)
+        {
+            return std::string_view(strings + ref.offset, ref.length);
+        };
+
+        if (!valid(header.ceoName))
+        {
+            return false;
+        }
+        for (uint64_t i = 0; i < header.ctoCount; ++i)
+        {
+            const SnapshotCTO &cto = ctos[i];
+            if (!valid(cto.name) || !valid(cto.field) || cto.firstMember > members ||
+                cto.memberCount > members - cto.firstMember)
+            {
+                return false;
+            }
+        }
+        for (uint64_t i = 0; i < members; ++i)
+        {
+            if (!valid(names[i]) || !valid(jobs[i]))
+            {
+                return false;
+            }
+        }
+
+        std::vector<CTO> loaded;
+        loaded.reserve(header.ctoCount);
+        for (uint64_t i = 0; i < header.ctoCount; ++i)
+        {
+            const SnapshotCTO &record = ctos[i];
+            loaded.emplace_back(std::string(view(record.name)), view(record.field));
+            CTO &cto = loaded.back();
+            size_t first = record.firstMember;
+            cto.team.appendColumns(
+                record.memberCount,
+                [&](size_t m)
+                { return view(names[first + m]); },
+                [&](size_t m)
+                { return view(jobs[first + m]); },
+                hours + first, contributions + first);
+            cto.totalContribution = cto.team.totalContribution();
+            cto.memberIndexReady = false; // Built on the first modify or remove
+        }
+
+        name = std::string(view(header.ceoName));
+        logSequence = header.logSequence;
+        ++epoch;
+        ctoList = std::move(loaded);
+        ctoIndex.clear();
+        leaderboard.clear();
+        snapshotStale.assign(ctoList.size(), true);
+        jobPostings.clear();
+        hoursIndex.assign({});
+        contributionIndex.assign({});
+        memberIndexesReady = false;
+        nameIndex = NameIndex();
+        nameIndexReady = false;
+        memberCount = 0;
+        teamSizeTree.assign(1, 0);
+        for (size_t position = 0; position < ctoList.size(); ++position)
+        {
+            CTO &cto = ctoList[position];
+            cto.owner = this;
+            cto.position = position;
+            ctoIndex.emplace(cto.getName(), position);
+            leaderboard.insert({cto.totalContribution, position});
+            appendTeamSize(position);
+        }
+        return true;
+    }
+    // Replays the log at path on top of the current state (normally the last
+    // snapshot), then appends every later mutation to it, syncing once per
+    // groupCommit records
+    bool openLog(const std::string &path, size_t groupCommit)
+    {
+        auto opened = std::make_unique<WriteAheadLog>(path, groupCommit);
+        if (!opened->replay([this](const MutationRecord &record)
+                            { applyMutation(record); }) ||
+            !opened->open())
+        {
+            return false;
+        }
+        log = std::move(opened);
+        return true;
+    }
+    bool hasLog() const
+    {
+        return log != nullptr;
+    }
+    // Makes every logged mutation durable now instead of at the next group commit
+    bool commitLog()
+    {
+        return !log || log->commit();
+    }
+    // Folds the log into a new snapshot at snapshotPath and empties the log.
+    // A crash in between is safe: the snapshot remembers the last sequence
+    // number it holds, so replay skips those records.
+    bool compactLog(const std::string &snapshotPath)
+    {
+        if (!log || !log->commit() || !saveSnapshot(snapshotPath))
+        {
+            return false;
+        }
+        return log->truncate();
+    }
+    // Makes the current state what readers get from openReader()->read().
+    // CTOs changed since the last publish are copied; the rest are shared
+    // with the previous snapshot. Called from the mutating thread only.
+    void publishSnapshot()
+    {
+        const OrgSnapshot &previous = snapshots.latest();
+        auto next = std::make_unique<OrgSnapshot>();
+        next->ceoName = name;
+        next->ctos.reserve(ctoList.size());
+        for (size_t position = 0; position < ctoList.size(); ++position)
+        {
+            if (snapshotStale[position])
+            {
+                next->ctos.push_back(ctoList[position].snapshotCopy());
+                snapshotStale[position] = false;
+            }
+            else
+            {
+                next->ctos.push_back(previous.ctos[position]);
+            }
+        }
+        if (!leaderboard.empty())
+        {
+            next->topCTO = next->ctos[leaderboard.begin()->second].get();
+        }
+        snapshots.publish(std::move(next));
+    }
+    // The k best contributors across the org, best first; ties go to the CTO
+    // added first. Merges the CTOs' own rankings, so it costs O(CTOs + k log
+    // CTOs) unless some CTO's ranking has to be rebuilt.
+    std::vector<MemberRow> getTopMembers(size_t k, WorkStealingPool *pool = nullptr)
+    {
+        using Cursor = std::set<std::pair<double, size_t>, RankOrder>::const_iterator;
+        std::vector<Cursor> cursors(ctoList.size());
+        std::set<std::pair<double, size_t>, RankOrder> heads; // (contribution, position): each CTO's next best
+        for (size_t position = 0; position < ctoList.size(); ++position)
+        {
+            CTO &cto = ctoList[position];
+            cto.ensureTopMembers(k, pool);
+            cursors[position] = cto.topMembers.begin();
+            if (cursors[position] != cto.topMembers.end())
+            {
+                heads.insert({cursors[position]->first, position});
+            }
+        }
+        std::vector<MemberRow> ranking;
+        while (!heads.empty() && ranking.size() < k)
+        {
+            size_t position = heads.begin()->second;
+            heads.erase(heads.begin());
+            const CTO &cto = ctoList[position];
+            ranking.push_back(cto.memberRow(cursors[position]->second));
+            if (++cursors[position] != cto.topMembers.end())
+            {
+                heads.insert({cursors[position]->first, position});
+            }
+        }
+        return ranking;
+    }
+    // Every member with this job title, grouped by CTO in ctoList order and
+    // by slot within a CTO. Costs O(r log r) in the r members found.
+    std::vector<MemberRow> findMembersWithJob(std::string_view job)
+    {
+        std::vector<MemberRow> rows;
+        if (const std::vector<uint64_t> *postings = jobPostingsFor(job))
+        {
+            std::vector<uint64_t> found = *postings;
+            std::sort(found.begin(), found.end());
+            rows.reserve(found.size());
+            for (uint64_t entry : found)
+            {
+                rows.push_back(ctoList[entry >> 32].memberRow(static_cast<uint32_t>(entry)));
+            }
+        }
+        return rows;
+    }
+    // How many members have this job title, for each CTO with any, in
+    // ctoList order. Costs O(r) in the r members with the job.
+    std::vector<std::pair<const CTO *, size_t>> countMembersWithJob(std::string_view job)
+    {
+        std::vector<std::pair<const CTO *, size_t>> counts;
+        if (const std::vector<uint64_t> *postings = jobPostingsFor(job))
+        {
+            std::unordered_map<size_t, size_t> perCTO;
+            for (uint64_t entry : *postings)
+            {
+                ++perCTO[entry >> 32];
+            }
+            std::vector<std::pair<size_t, size_t>> sorted(perCTO.begin(), perCTO.end());
+            std::sort(sorted.begin(), sorted.end());
+            for (const auto &[position, count] : sorted)
+            {
+                counts.push_back({&ctoList[position], count});
+            }
+        }
+        return counts;
+    }
+    // Up to k CTOs and members whose names start with prefix, ignoring
+    // case; shortest names first, then alphabetical, then in ctoList and
+    // slot order. The first search builds the name index.
+    std::vector<NameMatch> completeName(std::string_view prefix, size_t k)
+    {
+        ensureNameIndex();
+        return nameMatches(nameIndex.complete(prefix, k));
+    }
+    // Up to k CTOs and members whose names are at most maxDistance typos
+    // from name, ignoring case: fewest typos first, then closest in length
+    std::vector<NameMatch> findSimilarNames(std::string_view name, uint32_t maxDistance, size_t k)
+    {
+        ensureNameIndex();
+        return nameMatches(nameIndex.similar(name, maxDistance, k));
+    }
+    // Writes one page of members and returns how many rows match the request
+    // in all, so the caller can tell where the pages end. Only the page's rows
+    // are formatted. A page costs O(log n) plus its rows: storage order starts
+    // through teamSizeTree and the team's liveTree, and sorted pages through
+    // the org's range indexes or the CTO's rank indexes.
+    size_t writePage(ReportWriter &report, const PageRequest &request)
+    {
+        size_t first = 0, total = memberCount;
+        if (!request.cto.empty())
+        {
+            auto it = ctoIndex.find(request.cto);
+            if (it == ctoIndex.end())
+            {
+                return 0;
+            }
+            first = it->second;
+            total = ctoList[first].team.size();
+        }
+        size_t end = request.offset < total ? request.offset + std::min(request.pageSize, total - request.offset) : total;
+        if (request.offset >= end)
+        {
+            report.text("No rows on this page").endRow();
+            return total;
+        }
+
+        if (request.order == PageRequest::Order::Storage)
+        {
+            // Finds the CTO and slot holding each team's first row on the
+            // page, then walks slots, jumping over any run of free ones
+            for (size_t row = request.offset; row < end;)
+            {
+                size_t rank = row;
+                size_t position = request.cto.empty() ? ctoHoldingRow(rank) : first;
+                const CTO &cto = ctoList[position];
+                report.text("CTO: ").text(cto.getName()).text(" - Field: ").text(cto.getField()).endRow();
+                report.column("Name", 15).column("Job", 20).column("Hours", 10).column("Contribution", 15).endRow();
+                report.repeat('-', 60).endRow();
+                for (size_t slot = cto.team.nthMember(rank); rank < cto.team.size() && row < end; ++slot, ++rank, ++row)
+                {
+                    if (!cto.team.isAlive(slot))
+                    {
+                        slot = cto.team.nthMember(rank);
+                    }
+                    TeamMember::writeRow(report, cto.team.name(slot), cto.team.job(slot), cto.team.hoursWorked(slot),
+                                         cto.team.contribution(slot));
+                }
+            }
+        }
+        else
+        {
+            report.column("CTO", 15).column("Name", 15).column("Job", 20).column("Hours", 10).column("Contribution", 15).endRow();
+            report.repeat('-', 75).endRow();
+            auto writeRow = [&](size_t position, size_t slot)
+            {
+                const CTO &cto = ctoList[position];
+                report.column(cto.getName(), 15);
+                TeamMember::writeRow(report, cto.team.name(slot), cto.team.job(slot), cto.team.hoursWorked(slot),
+                                     cto.team.contribution(slot));
+            };
+            bool byHours = request.order == PageRequest::Order::Hours;
+            if (request.cto.empty())
+            {
+                ensureMemberIndexes();
+                size_t rows = end - request.offset;
+                auto write = [&](const auto &entry)
+                {
+                    writeRow(entry.second >> 32, static_cast<uint32_t>(entry.second));
+                    return --rows > 0;
+                };
+                if (byHours)
+                {
+                    hoursIndex.forEachFrom(request.offset, request.descending, write);
+                }
+                else
+                {
+                    contributionIndex.forEachFrom(request.offset, request.descending, write);
+                }
+            }
+            else
+            {
+                CTO &cto = ctoList[first];
+                cto.ensureRankIndexes();
+                size_t rows = end - request.offset;
+                auto write = [&](const auto &entry)
+                {
+                    writeRow(first, static_cast<size_t>(entry.second));
+                    return --rows > 0;
+                };
+                if (byHours)
+                {
+                    cto.hoursRanks.forEachFrom(request.offset, request.descending, write);
+                }
+                else
+                {
+                    cto.contributionRanks.forEachFrom(request.offset, request.descending, write);
+                }
+            }
+        }
+        report.text("Rows ").column(request.offset + 1, 0).text("-").column(end, 0);
+        report.text(" of ").column(total, 0).endRow();
+        return total;
+    }
+    // Members with lo <= hours worked <= hi, and their rows in order of hours.
+    // O(log n) to count, plus O(r) to list r members.
+    size_t countByHours(int lo, int hi)
+    {
+        ensureMemberIndexes();
+        return hoursIndex.count(lo, hi);
+    }
+    std::vector<MemberRow> findByHours(int lo, int hi)
+    {
+        ensureMemberIndexes();
+        std::vector<MemberRow> rows;
+        hoursIndex.forEach(lo, hi, [&](const RangeIndex<int>::Entry &entry)
+                           { rows.push_back(ctoList[entry.second >> 32].memberRow(static_cast<uint32_t>(entry.second))); });
+        return rows;
+    }
+    // The same for lo <= contribution <= hi, in order of contribution
+    size_t countByContribution(double lo, double hi)
+    {
+        ensureMemberIndexes();
+        return contributionIndex.count(lo, hi);
+    }
+    std::vector<MemberRow> findByContribution(double lo, double hi)
+    {
+        ensureMemberIndexes();
+        std::vector<MemberRow> rows;
+        contributionIndex.forEach(lo, hi, [&](const RangeIndex<double>::Entry &entry)
+                                  { rows.push_back(ctoList[entry.second >> 32].memberRow(static_cast<uint32_t>(entry.second))); });
+        return rows;
+    }
+    // Counts, sums, minimums, maximums and means of hours and contribution for
+    // every CTO and the whole org, in one pass over the columns on pool's
+    // threads. Big teams are split into ranges of about grain slots and small
+    // teams are batched into tasks of about that size.
+    OrgAggregate aggregate(WorkStealingPool &pool, size_t grain = 1 << 16) const
+    {
+        struct Piece
+        {
+            size_t position, first, last;
+        };
+        std::vector<Piece> pieces;
+        std::vector<std::function<void()>> tasks;
+        std::vector<TeamAggregate> partials;
+        size_t taskStart = 0, taskSlots = 0;
+        auto closeTask = [&]
+        {
+            if (taskStart < pieces.size())
+            {
+                tasks.push_back([this, &pieces, &partials, begin = taskStart, end = pieces.size()]
+                                {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        partials[i] = ctoList[pieces[i].position].team.aggregate(pieces[i].first, pieces[i].last);
+                    } });
+            }
+            taskStart = pieces.size();
+            taskSlots = 0;
+        };
+        for (size_t position = 0; position < ctoList.size(); ++position)
+        {
+            size_t slots = ctoList[position].team.slotCount();
+            for (size_t first = 0; first < slots; first += grain)
+            {
+                size_t last = std::min(slots, first + grain);
+                pieces.push_back({position, first, last});
+                taskSlots += last - first;
+                if (taskSlots >= grain)
+                {
+                    closeTask();
+                }
+            }
+        }
+        closeTask();
+        partials.resize(pieces.size());
+        pool.run(std::move(tasks));
+
+        OrgAggregate result;
+        result.ctos.resize(ctoList.size());
+        for (size_t i = 0; i < pieces.size(); ++i)
+        {
+            result.ctos[pieces[i].position].merge(partials[i]);
+        }
+        for (const auto &cto : result.ctos)
+        {
+            result.org.merge(cto);
+        }
+        return result;
+    }
+    // For reader threads; see SnapshotReader
+    std::unique_ptr<SnapshotReader> openReader()
+    {
+        return snapshots.openReader();
+    }
+    // The k CTOs with the highest total contribution, best first
+    std::vector<const CTO *> getTopCTOs(size_t k) const
+    {
+        std::vector<const CTO *> top;
+        for (auto it = leaderboard.begin(); it != leaderboard.end() && top.size() < k; ++it)
+        {
+            top.push_back(&ctoList[it->second]);
+        }
+        return top;
+    }
+};
+
+void CTO::notifyChanged(double oldTotal)
+{
+    if (owner)
+    {
+        owner->updateRanking(position, oldTotal, totalContribution);
+        owner->snapshotStale[position] = true;
+    }
+}
+
+void CTO::resized(ptrdiff_t delta)
+{
+    if (owner)
+    {
+        owner->resizeTeam(position, delta);
+    }
+}
+
+void CTO::indexMember(size_t slot)
+{
+    if (rankIndexesReady)
+    {
+        hoursRanks.insert({team.hoursWorked(slot), slot});
+        contributionRanks.insert({team.contribution(slot), slot});
+    }
+    if (owner && owner->memberIndexesReady)
+    {
+        owner->postMember(position, slot);
+    }
+}
+
+void CTO::unindexMember(size_t slot)
+{
+    if (rankIndexesReady)
+    {
+        hoursRanks.erase({team.hoursWorked(slot), slot});
+        contributionRanks.erase({team.contribution(slot), slot});
+    }
+    if (owner && owner->memberIndexesReady)
+    {
+        owner->unpostMember(position, slot);
+    }
+}
+
+void CTO::indexName(size_t slot)
+{
+    if (owner && owner->nameIndexReady)
+    {
+        owner->nameIndex.insert(team.name(slot), uint64_t(position) << 32 | slot);
+    }
+}
+
+void CTO::unindexName(size_t slot)
+{
+    if (owner && owner->nameIndexReady)
+    {
+        owner->nameIndex.erase(team.name(slot), uint64_t(position) << 32 | slot);
+    }
+}
+
+void CTO::logMutation(MutationRecord record)
+{
+    if (owner)
+    {
+        record.cto = name;
+        record.position = static_cast<uint32_t>(position);
+        owner->recordMutation(record);
+    }
+}
+
+// Totals over one person's subtree, that person included
+struct SubtreeTotals
+{
+    size_t people = 0;
+    long long hours = 0;
+    double contribution = 0;
+};
+
+// An organization of any depth: the CEO at the root, then any mix of
+// managers (directors, CTOs, leads...) with team members as the leaves.
+// People live in flat arrays indexed by Node, with parent and sibling links.
+// The hierarchy is also kept as an Euler tour, in which everyone appears
+// twice with their whole subtree in between. The tour is an implicit treap
+// (a balanced tree over tour positions) whose nodes carry the sums of their
+// part of the tour, so subtree totals, moving a subtree under a new parent,
+// and adding, updating or removing one person all cost O(log n). The treap
+// stands in for a Fenwick tree over a fixed tour, which could not move a
+// subtree without renumbering everything after it. topSubtree is the one
+// query that is not O(log n): it compares each child's total, O(log n)
+// apiece. Keeping that answer ready would mean updating an ordering at
+// every ancestor on each change, O(depth log n), which is worse on a deep org.
+class OrgTree
+{
+public:
+    using Node = uint32_t;
+    static constexpr Node none = std::numeric_limits<Node>::max();
+    static constexpr Node root = 0; // The CEO
+
+private:
+    std::vector<std::string> names;
+    std::vector<uint32_t> titleIds; // Role for managers, job for members; in sharedStrings()
+    std::vector<uint32_t> fieldIds; // Managers' field; in sharedStrings()
+    std::vector<uint8_t> isManager;
+    std::vector<int> hours;
+    std::vector<double> contributions;
+    std::vector<Node> parents, firstChildren, lastChildren, nextSiblings, previousSiblings;
+
+    // Node n enters the tour as token 2n, carrying its hours and contribution,
+    // and leaves it as token 2n + 1, which carries nothing
+    struct TourNode
+    {
+        uint32_t left = none, right = none, up = none;
+        uint32_t priority = 0;
+        uint32_t size = 1;   // Tokens in this treap subtree
+        uint32_t people = 0; // Enter tokens among them
+        long long hours = 0;
+        double contribution = 0;
+    };
+    std::vector<TourNode> tour;
+    uint32_t tourRoot = none;
+    uint64_t random = 0x9E3779B97F4A7C15ull; // Treap priorities; fixed seed, so shapes repeat run to run
+
+    uint32_t nextPriority()
+    {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        return static_cast<uint32_t>(random >> 32);
+    }
+    uint32_t sizeOf(uint32_t token) const
+    {
+        return token == none ? 0 : tour[token].size;
+    }
+    // Adds token's own values, without its treap children
+    void addOwn(uint32_t token, SubtreeTotals &totals) const
+    {
+        if (token % 2 == 0)
+        {
+            totals.people += 1;
+            totals.hours += hours[token / 2];
+            totals.contribution += contributions[token / 2];
+        }
+    }
+    void addAll(uint32_t token, SubtreeTotals &totals) const
+    {
+        if (token != none)
+        {
+            totals.people += tour[token].people;
+            totals.hours += tour[token].hours;
+            totals.contribution += tour[token].contribution;
+        }
+    }
+    // Recomputes token's sums from its children
+    void pull(uint32_t token)
+    {
+        SubtreeTotals totals;
+        addAll(tour[token].left, totals);
+        addOwn(token, totals);
+        addAll(tour[token].right, totals);
+        TourNode &node = tour[token];
+        node.size = 1 + sizeOf(node.left) + sizeOf(node.right);
+        node.people = static_cast<uint32_t>(totals.people);
+        node.hours = totals.hours;
+        node.contribution = totals.contribution;
+    }
+    void setUp(uint32_t token, uint32_t up)
+    {
+        if (token != none)
+        {
+            tour[token].up = up;
+        }
+    }
+    // The first count tokens of treap go to first, the rest to rest
+    void split(uint32_t treap, uint32_t count, uint32_t &first, uint32_t &rest)
+    {
+        if (treap == none)
+        {
+            first = rest = none;
+            return;
+        }
+        uint32_t leftSize = sizeOf(tour[treap].left);
+        if (count <= leftSize)
+        {
+            uint32_t leftRest;
+            split(tour[treap].left, count, first, leftRest);
+            tour[treap].left = leftRest;
+            setUp(leftRest, treap);
+            rest = treap;
+        }
+        else
+        {
+            uint32_t rightFirst;
+            split(tour[treap].right, count - leftSize - 1, rightFirst, rest);
+            tour[treap].right = rightFirst;
+            setUp(rightFirst, treap);
+            first = treap;
+        }
+        pull(treap);
+        setUp(first, none);
+        setUp(rest, none);
+    }
+    uint32_t merge(uint32_t first, uint32_t second)
+    {
+        if (first == none || second == none)
+        {
+            return first == none ? second : first;
+        }
+        if (tour[first].priority > tour[second].priority)
+        {
+            uint32_t right = merge(tour[first].right, second);
+            tour[first].right = right;
+            setUp(right, first);
+            pull(first);
+            return first;
+        }
+        uint32_t left = merge(first, tour[second].left);
+        tour[second].left = left;
+        setUp(left, second);
+        pull(second);
+        return second;
+    }
+    // Where token is in the tour
+    uint32_t position(uint32_t token) const
+    {
+        uint32_t result = sizeOf(tour[token].left);
+        for (uint32_t up = tour[token].up; up != none; token = up, up = tour[up].up)
+        {
+            if (tour[up].right == token)
+            {
+                result += sizeOf(tour[up].left) + 1;
+            }
+        }
+        return result;
+    }
+    // Adds tour positions [from, to) to totals, walking down from the treap root
+    void addRange(uint32_t from, uint32_t to, SubtreeTotals &totals) const
+    {
+        uint32_t token = tourRoot;
+        while (token != none && from < to)
+        {
+            if (from == 0 && to >= tour[token].size)
+            {
+                addAll(token, totals);
+                return;
+            }
+            uint32_t leftSize = sizeOf(tour[token].left);
+            if (to <= leftSize)
+            {
+                token = tour[token].left;
+            }
+            else if (from > leftSize)
+            {
+                from -= leftSize + 1;
+                to -= leftSize + 1;
+                token = tour[token].right;
+            }
+            else
+            {
+                // The range covers token: a suffix of its left subtree, token
+                // itself, then a prefix of its right subtree
+                addOwn(token, totals);
+                for (uint32_t left = tour[token].left; left != none && from < tour[left].size;)
+                {
+                    uint32_t size = sizeOf(tour[left].left);
+                    if (from <= size)
+                    {
+                        addOwn(left, totals);
+                        addAll(tour[left].right, totals);
+                        left = tour[left].left;
+                    }
+                    else
+                    {
+                        from -= size + 1;
+                        left = tour[left].right;
+                    }
+                }
+                uint32_t count = to - leftSize - 1;
+                for (uint32_t right = tour[token].right; right != none && count > 0;)
+                {
+                    uint32_t size = sizeOf(tour[right].left);
+                    if (count <= size)
+                    {
+                        right = tour[right].left;
+                    }
+                    else
+                    {
+                        addAll(tour[right].left, totals);
+                        addOwn(right, totals);
+                        count -= size + 1;
+                        right = tour[right].right;
+                    }
+                }
+                return;
+            }
+        }
+    }
+    Node newPerson(Node parent, std::string name, bool manager, std::string_view title, std::string_view field,
+                   int personHours, double personContribution)
+    {
+        Node node = static_cast<Node>(names.size());
+        names.push_back(std::move(name));
+        titleIds.push_back(sharedStrings().intern(title));
+        fieldIds.push_back(sharedStrings().intern(field));
+        isManager.push_back(manager);
+        hours.push_back(personHours);
+        contributions.push_back(personContribution);
+        parents.push_back(parent);
+        firstChildren.push_back(none);
+        lastChildren.push_back(none);
+        nextSiblings.push_back(none);
+        previousSiblings.push_back(none);
+        linkChild(parent, node);
+        for (int i = 0; i < 2; ++i)
+        {
+            tour.emplace_back();
+            tour.back().priority = nextPriority();
+            pull(static_cast<uint32_t>(tour.size() - 1));
+        }
+        return node;
+    }
+    // Makes node the last child of parent
+    void linkChild(Node parent, Node node)
+    {
+        parents[node] = parent;
+        nextSiblings[node] = none;
+        if (parent == none)
+        {
+            previousSiblings[node] = none;
+            return;
+        }
+        previousSiblings[node] = lastChildren[parent];
+        if (lastChildren[parent] == none)
+        {
+            firstChildren[parent] = node;
+        }
+        else
+        {
+            nextSiblings[lastChildren[parent]] = node;
+        }
+        lastChildren[parent] = node;
+    }
+    void unlinkChild(Node node)
+    {
+        Node parent = parents[node];
+        if (previousSiblings[node] == none)
+        {
+            firstChildren[parent] = nextSiblings[node];
+        }
+        else
+        {
+            nextSiblings[previousSiblings[node]] = nextSiblings[node];
+        }
+        if (nextSiblings[node] == none)
+        {
+            lastChildren[parent] = previousSiblings[node];
+        }
+        else
+        {
+            previousSiblings[nextSiblings[node]] = previousSiblings[node];
+        }
+    }
+    // Puts a new person's tour tokens just before the parent's leave token,
+    // the same place linkChild gives them among the parent's children
+    void insertIntoTour(Node node)
+    {
+        uint32_t before, after;
+        split(tourRoot, position(2 * parents[node] + 1), before, after);
+        tourRoot = merge(merge(before, merge(2 * node, 2 * node + 1)), after);
+    }
+    // Rebuilds the whole treap from tokens in tour order in O(n): the
+    // Cartesian tree of their priorities, built along its right spine
+    void buildTour(const std::vector<uint32_t> &tokens)
+    {
+        std::vector<uint32_t> spine;
+        for (uint32_t token : tokens)
+        {
+            uint32_t last = none;
+            while (!spine.empty() && tour[spine.back()].priority < tour[token].priority)
+            {
+                last = spine.back();
+                spine.pop_back();
+                pull(last);
+            }
+            tour[token].left = last;
+            setUp(last, token);
+            tour[token].right = none;
+            if (!spine.empty())
+            {
+                tour[spine.back()].right = token;
+            }
+            tour[token].up = spine.empty() ? none : spine.back();
+            spine.push_back(token);
+        }
+        while (!spine.empty())
+        {
+            pull(spine.back());
+            spine.pop_back();
+        }
+        tourRoot = tokens.empty() ? none : tokens.front();
+        while (tourRoot != none && tour[tourRoot].up != none)
+        {
+            tourRoot = tour[tourRoot].up;
+        }
+    }
+    // Removed people keep their node number, but lose their parent
+    bool isPerson(Node node) const
+    {
+        return node < names.size() && (node == root || parents[node] != none);
+    }
+    // Writes one manager's table of the team members directly under them
+    void writeTeam(ReportWriter &report, Node manager) const
+    {
+        report.column("Name", 15).column("Job", 20).column("Hours", 10).column("Contribution", 15).endRow();
+        report.repeat('-', 60).endRow();
+        for (Node child = firstChildren[manager]; child != none; child = nextSiblings[child])
+        {
+            if (!isManager[child])
+            {
+                TeamMember::writeRow(report, names[child], sharedStrings().get(titleIds[child]), hours[child],
+                                     contributions[child]);
+            }
+        }
+    }
+
+public:
+    explicit OrgTree(std::string ceoName)
+    {
+        newPerson(none, std::move(ceoName), true, "CEO", "", 0, 0);
+        tourRoot = merge(0, 1);
+    }
+    // The CEO's organization as a three-level tree: the CEO, each CTO in the
+    // order added, and each CTO's team in display order
+    explicit OrgTree(const CEO &ceo)
+    {
+        size_t people = 1;
+        for (const CTO &cto : ceo.ctoList)
+        {
+            people += 1 + cto.team.size();
+        }
+        names.reserve(people);
+        tour.reserve(2 * people);
+        std::vector<uint32_t> tokens;
+        tokens.reserve(2 * people);
+        tokens.push_back(2 * newPerson(none, ceo.getName(), true, "CEO", "", 0, 0));
+        for (const CTO &cto : ceo.ctoList)
+        {
+            Node manager = newPerson(root, cto.getName(), true, "CTO", cto.getField(), 0, 0);
+            tokens.push_back(2 * manager);
+            cto.team.forEachMember([&](size_t slot)
+                                   {
+                Node member = newPerson(manager, std::string(cto.team.name(slot)), false, cto.team.job(slot), "",
+                                        cto.team.hoursWorked(slot), cto.team.contribution(slot));
+                tokens.push_back(2 * member);
+                tokens.push_back(2 * member + 1); });
+            tokens.push_back(2 * manager + 1);
+        }
+        tokens.push_back(1);
+        buildTour(tokens);
+    }
+
+    // Both return none if parent is not a manager in this tree
+    Node addManager(Node parent, std::string name, std::string_view role, std::string_view field)
+    {
+        if (!isPerson(parent) || !isManager[parent])
+        {
+            return none;
+        }
+        Node node = newPerson(parent, std::move(name), true, role, field, 0, 0);
+        insertIntoTour(node);
+        return node;
+    }
+    Node addMember(Node parent, std::string name, std::string_view job, int memberHours, double contribution)
+    {
+        if (!isPerson(parent) || !isManager[parent])
+        {
+            return none;
+        }
+        Node node = newPerson(parent, std::move(name), false, job, "", memberHours, contribution);
+        insertIntoTour(node);
+        return node;
+    }
+    // Updates the sums on the path from the person's tour token to the treap root
+    bool modifyMember(Node member, std::string_view job, int memberHours, double contribution)
+    {
+        if (!isPerson(member) || isManager[member])
+        {
+            return false;
+        }
+        titleIds[member] = sharedStrings().intern(job);
+        hours[member] = memberHours;
+        contributions[member] = contribution;
+        for (uint32_t token = 2 * member; token != none; token = tour[token].up)
+        {
+            pull(token);
+        }
+        return true;
+    }
+    // Takes a member's two adjacent tokens out of the tour. The node number
+    // is not reused; the member no longer counts as a person.
+    bool removeMember(Node member)
+    {
+        if (!isPerson(member) || isManager[member])
+        {
+            return false;
+        }
+        uint32_t before, removed, after;
+        split(tourRoot, position(2 * member), before, removed);
+        split(removed, 2, removed, after);
+        tourRoot = merge(before, after);
+        unlinkChild(member);
+        parents[member] = none;
+        return true;
+    }
+    // Moves node, with everyone under it, to be the last child of newParent.
+    // Fails for the CEO, and if newParent is not a manager or is inside
+    // node's own subtree.
+    bool reparent(Node node, Node newParent)
+    {
+        if (!isPerson(node) || node == root || !isPerson(newParent) || !isManager[newParent])
+        {
+            return false;
+        }
+        uint32_t enter = position(2 * node), leave = position(2 * node + 1);
+        uint32_t target = position(2 * newParent);
+        if (target >= enter && target <= leave)
+        {
+            return false;
+        }
+        uint32_t before, rest, moved, after;
+        split(tourRoot, enter, before, rest);
+        split(rest, leave - enter + 1, moved, after);
+        tourRoot = merge(before, after);
+        split(tourRoot, position(2 * newParent + 1), before, after);
+        tourRoot = merge(merge(before, moved), after);
+
+        unlinkChild(node);
+        linkChild(newParent, node);
+        return true;
+    }
+    SubtreeTotals subtreeTotals(Node node) const
+    {
+        SubtreeTotals totals;
+        if (isPerson(node))
+        {
+            addRange(position(2 * node), position(2 * node + 1) + 1, totals);
+        }
+        return totals;
+    }
+    // The child of parent whose subtree contributes the most (the first such
+    // child on a tie), or none if parent has no children. O(children log n).
+    Node topSubtree(Node parent) const
+    {
+        Node best = none;
+        double bestContribution = 0;
+        for (Node child = isPerson(parent) ? firstChildren[parent] : none; child != none; child = nextSiblings[child])
+        {
+            double contribution = subtreeTotals(child).contribution;
+            if (best == none || contribution > bestContribution)
+            {
+                best = child;
+                bestContribution = contribution;
+            }
+        }
+        return best;
+    }
+    // Node numbers handed out so far, removed members included
+    size_t size() const
+    {
+        return names.size();
+    }
+    Node parentOf(Node node) const
+    {
+        return isPerson(node) ? parents[node] : none;
+    }
+    const std::string &getName(Node node) const
+    {
+        return names[node];
+    }
+    // The CEO line, then every manager below the CEO in tree order: a
+    // "<role>: name - Field: field" line and the table of their direct team
+    // members. For a tree built from a CEO this is exactly CEO::writeReport.
+    void writeReport(ReportWriter &report) const
+    {
+        report.text("CEO: ").text(names[root]).endRow();
+        std::vector<Node> pending{root};
+        while (!pending.empty())
+        {
+            Node manager = pending.back();
+            pending.pop_back();
+            bool hasMembers = false, hasManagers = false;
+            for (Node child = lastChildren[manager]; child != none; child = previousSiblings[child])
+            {
+                (isManager[child] ? hasManagers : hasMembers) = true;
+                if (isManager[child])
+                {
+                    pending.push_back(child);
+                }
+            }
+            if (manager == root)
+            {
+                if (hasMembers)
+                {
+                    writeTeam(report, root);
+                    report.endRow();
+                }
+                continue;
+            }
+            report.text(sharedStrings().get(titleIds[manager])).text(": ").text(names[manager]);
+            report.text(" - Field: ").text(sharedStrings().get(fieldIds[manager])).endRow();
+            if (hasMembers || !hasManagers)
+            {
+                writeTeam(report, manager);
+            }
+            report.endRow();
+        }
+    }
+    void displayInfo() const
+    {
+        ReportWriter report(std::cout);
+        writeReport(report);
+    }
+};
+
+// Reads a batch command stream in large chunks and hands it out line by line,
+// so loading a big org does not pay for one stream extraction per field
+class BatchReader
+{
+    std::FILE *in;
+    std::vector<char> buffer;
+    size_t begin = 0; // First unread byte in buffer
+    size_t end = 0;   // One past the last filled byte in buffer
+    bool eof = false;
+
+public:
+    explicit BatchReader(std::FILE *input) : in(input), buffer(1 << 20) {}
+    bool nextLine(std::string_view &line)
+    {
+        while (true)
+        {
+            const char *start = buffer.data() + begin;
+            const char *newline = static_cast<const char *>(std::memchr(start, '\n', end - begin));
+            if (newline || (eof && begin < end))
+            {
+                size_t length = newline ? static_cast<size_t>(newline - start) : end - begin;
+                begin += newline ? length + 1 : length;
+                if (length > 0 && start[length - 1] == '\r')
+                {
+                    --length;
+                }
+                line = std::string_view(start, length);
+                return true;
+            }
+            if (eof)
+            {
+                return false;
+            }
+            // Keep the unfinished line, moved to the front, and refill behind it
+            size_t partial = end - begin;
+            if (partial == buffer.size())
+            {
+                buffer.resize(buffer.size() * 2);
+            }
+            std::memmove(buffer.data(), buffer.data() + begin, partial);
+            begin = 0;
+            end = partial;
+            size_t got = std::fread(buffer.data() + end, 1, buffer.size() - end, in);
+            end += got;
+            eof = (got == 0);
+        }
+    }
+};
+
+// Splits text on '|' into at most maxFields fields; returns how many were found
+size_t splitFields(std::string_view text, std::string_view *fields, size_t maxFields)
+{
+    size_t count = 0;
+    while (count < maxFields)
+    {
+        size_t bar = text.find('|');
+        fields[count++] = text.substr(0, bar);
+        if (bar == std::string_view::npos)
+        {
+            return count;
+        }
+        text.remove_prefix(bar + 1);
+    }
+    return maxFields + 1; // More fields than expected
+}
+
+template <typename T>
+bool parseNumber(std::string_view text, T &value)
+{
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+struct ImportStats
+{
+    size_t rows = 0;
+    size_t errors = 0;
+    size_t ctosAdded = 0;
+    size_t firstErrorLine = 0; // 1-based; 0 when every row was good
+    double seconds = 0;
+};
+
+// Splits one CSV line into at most maxFields fields. Fields may be quoted,
+// with "" standing for a quote; only those fields are copied, into unquoted.
+size_t splitCSV(std::string_view line, std::string_view *fields, size_t maxFields, std::deque<std::string> &unquoted)
+{
+    size_t count = 0;
+    size_t i = 0;
+    while (true)
+    {
+        if (count == maxFields)
+        {
+            return maxFields + 1; // More fields than expected
+        }
+        if (i < line.size() && line[i] == '"')
+        {
+            std::string text;
+            for (++i; i < line.size(); ++i)
+            {
+                if (line[i] == '"')
+                {
+                    if (i + 1 < line.size() && line[i + 1] == '"')
+                    {
+                        ++i;
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+                text.push_back(line[i]);
+            }
+            if (i >= line.size())
+            {
+                return 0; // Unterminated quote
+            }
+            ++i;
+            unquoted.push_back(std::move(text));
+            fields[count++] = unquoted.back();
+            if (i < line.size() && line[i] != ',')
+            {
+                return 0;
+            }
+        }
+        else
+        {
+            size_t comma = line.find(',', i);
+            fields[count++] = line.substr(i, comma == std::string_view::npos ? std::string_view::npos : comma - i);
+            i = comma == std::string_view::npos ? line.size() : comma;
+        }
+        if (i >= line.size())
+        {
+            return count;
+        }
+        ++i; // Skip the comma
+    }
+}
+
+// Imports a CSV export with rows of cto,field,member,job,hours,contribution.
+// The mapped file is cut into one chunk per thread at line boundaries; each
+// thread parses its chunk and groups the rows by CTO. The groups are then
+// appended to their CTOs in file order, one bulk append per group, with each
+// team reserved up front. CTOs that do not exist yet are added with the field
+// of their first row. A first line starting with "cto," is taken as a header.
+bool importCSV(CEO &ceo, const std::string &path, unsigned threadCount, ImportStats &stats)
+{
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file(path);
+    if (!file.data())
+    {
+        return false;
+    }
+    std::string_view text(file.data(), file.size());
+    size_t headerLines = 0;
+    if (text.substr(0, 4) == "cto,")
+    {
+        size_t newline = text.find('\n');
+        text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+        headerLines = 1;
+    }
+
+    struct Group
+    {
+        std::string_view cto;
+        std::string_view field;
+        std::vector<std::string_view> names;
+        std::vector<std::string_view> jobs;
+        std::vector<int> hours;
+        std::vector<double> contributions;
+    };
+    struct Chunk
+    {
+        std::string_view text;
+        std::vector<Group> groups; // In order of first appearance
+        std::deque<std::string> unquoted;
+        size_t lines = 0;
+        size_t rows = 0;
+        size_t errors = 0;
+        size_t firstErrorLine = 0; // Within the chunk, 1-based
+    };
+
+    threadCount = std::max(1u, threadCount);
+    std::vector<Chunk> chunks(threadCount);
+    size_t begin = 0;
+    for (unsigned t = 0; t < threadCount; ++t)
+    {
+        size_t end = t + 1 == threadCount ? text.size() : std::max(begin, text.size() * (t + 1) / threadCount);
+        size_t newline = text.find('\n', end == 0 ? 0 : end - 1);
+        end = (t + 1 == threadCount || newline == std::string_view::npos) ? text.size() : newline + 1;
+        chunks[t].text = text.substr(begin, end - begin);
+        begin = end;
+    }
+
+    auto parse = [](Chunk &chunk)
+    {
+        std::unordered_map<std::string_view, size_t> groupIndex;
+        std::string_view rest = chunk.text;
+        std::string_view fields[6];
+        while (!rest.empty())
+        {
+            size_t newline = rest.find('\n');
+            std::string_view line = rest.substr(0, newline);
+            rest.remove_prefix(newline == std::string_view::npos ? rest.size() : newline + 1);
+            ++chunk.lines;
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+            if (line.empty())
+            {
+                continue;
+            }
+            int hours;
+            double contribution;
+            if (splitCSV(line, fields, 6, chunk.unquoted) != 6 || !parseNumber(fields[4], hours) ||
+                !parseNumber(fields[5], contribution) || !std::isfinite(contribution))
+            {
+                if (chunk.errors++ == 0)
+                {
+                    chunk.firstErrorLine = chunk.lines;
+                }
+                continue;
+            }
+            auto found = groupIndex.try_emplace(fields[0], chunk.groups.size());
+            if (found.second)
+            {
+                chunk.groups.push_back({fields[0], fields[1], {}, {}, {}, {}});
+            }
+            Group &group = chunk.groups[found.first->second];
+            group.names.push_back(fields[2]);
+            group.jobs.push_back(fields[3]);
+            group.hours.push_back(hours);
+            group.contributions.push_back(contribution);
+            ++chunk.rows;
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threadCount; ++t)
+    {
+        workers.emplace_back(parse, std::ref(chunks[t]));
+    }
+    parse(chunks[0]);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    // Gathers each CTO's groups from every chunk, keeping file order
+    std::vector<std::vector<const Group *>> byCTO;
+    std::unordered_map<std::string_view, size_t> ctoOrder;
+    size_t lineOffset = headerLines;
+    for (const Chunk &chunk : chunks)
+    {
+        for (const Group &group : chunk.groups)
+        {
+            auto found = ctoOrder.try_emplace(group.cto, byCTO.size());
+            if (found.second)
+            {
+                byCTO.emplace_back();
+            }
+            byCTO[found.first->second].push_back(&group);
+        }
+        stats.rows += chunk.rows;
+        stats.errors += chunk.errors;
+        if (stats.firstErrorLine == 0 && chunk.errors > 0)
+        {
+            stats.firstErrorLine = lineOffset + chunk.firstErrorLine;
+        }
+        lineOffset += chunk.lines;
+    }
+    for (const auto &groups : byCTO)
+    {
+        std::string ctoName(groups.front()->cto);
+        CTO *cto = ceo.getCTO(ctoName);
+        if (!cto)
+        {
+            ceo.addCTO(CTO(ctoName, groups.front()->field));
+            cto = ceo.getCTO(ctoName);
+            ++stats.ctosAdded;
+        }
+        size_t total = 0;
+        for (const Group *group : groups)
+        {
+            total += group->names.size();
+        }
+        cto->reserveMembers(total);
+        for (const Group *group : groups)
+        {
+            cto->addNewMembers(
+                group->names.size(),
+                [group](size_t i)
+                { return group->names[i]; },
+                [group](size_t i)
+                { return group->jobs[i]; },
+                group->hours.data(), group->contributions.data());
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+void printImportStats(const ImportStats &stats)
+{
+    std::cout << "Imported " << stats.rows << " rows into " << stats.ctosAdded << " new CTOs in " << stats.seconds
+              << " s, " << (stats.seconds > 0 ? stats.rows / stats.seconds : 0) << " rows/s\n";
+    if (stats.errors > 0)
+    {
+        std::cout << "Skipped " << stats.errors << " bad rows, the first on line " << stats.firstErrorLine << "\n";
+    }
+}
+
+// The menu operations whose latency is recorded
+enum class Operation
+{
+    AddCTO,
+    AddMember,
+    ModifyMember,
+    RemoveMember,
+    Display,
+    TopCTO,
+    Count
+};
+
+// Latency histograms and call counts for each Operation. Every thread
+// records into its own buffer, so a sample costs two timestamp reads and a
+// few uncontended stores; write() merges the buffers. There is exactly one,
+// from operationStats(), since each thread's buffer pointer is static.
+class OperationStats
+{
+    // Log-linear buckets as in HdrHistogram: one per tick below 64 ticks, then
+    // 32 per power of two, so any value is within about 3% of its bucket
+    static constexpr unsigned subBits = 5;
+    static constexpr size_t subCount = size_t(1) << subBits;
+    static constexpr size_t bucketCount = (64 - subBits + 1) * subCount;
+    static constexpr size_t operationCount = static_cast<size_t>(Operation::Count);
+
+    // Only its own thread writes a buffer, so relaxed load-then-store is
+    // enough and compiles to plain moves; write() may read it at any time
+    struct ThreadBuffer
+    {
+        std::array<std::array<std::atomic<uint64_t>, bucketCount>, operationCount> buckets;
+        std::array<std::atomic<uint64_t>, operationCount> calls;
+        std::array<std::atomic<uint64_t>, operationCount> maxTicks;
+    };
+
+    std::mutex lock; // Guards buffers
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers; // Kept after their thread exits
+    uint64_t startTicks = now();
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    static size_t bucketOf(uint64_t ticks)
+    {
+        if (ticks < 2 * subCount)
+        {
+            return static_cast<size_t>(ticks);
+        }
+#ifdef _MSC_VER
+        unsigned long magnitude;
+        _BitScanReverse64(&magnitude, ticks);
+#else
+        unsigned magnitude = 63 - static_cast<unsigned>(__builtin_clzll(ticks));
+#endif
+        return (magnitude - subBits) * subCount + static_cast<size_t>(ticks >> (magnitude - subBits));
+    }
+    // The largest tick count that lands in bucket
+    static uint64_t highestIn(size_t bucket)
+    {
+        if (bucket < 2 * subCount)
+        {
+            return bucket;
+        }
+        unsigned shift = static_cast<unsigned>(bucket / subCount) - 1;
+        uint64_t lowest = static_cast<uint64_t>(bucket % subCount + subCount) << shift;
+        return lowest + ((uint64_t(1) << shift) - 1);
+    }
+    static void bump(std::atomic<uint64_t> &counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    ThreadBuffer &local()
+    {
+        thread_local ThreadBuffer *buffer = nullptr;
+        if (!buffer)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            buffers.push_back(std::make_unique<ThreadBuffer>()); // Value-initialized, so every count starts at 0
+            buffer = buffers.back().get();
+        }
+        return *buffer;
+    }
+
+    OperationStats() = default;
+    friend OperationStats &operationStats();
+
+public:
+    OperationStats(const OperationStats &) = delete;
+    OperationStats &operator=(const OperationStats &) = delete;
+
+    // Ticks of the cycle counter where there is one (constant-rate on any
+    // x86-64 from the last decade), nanoseconds otherwise
+    static uint64_t now()
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#endif
+    }
+    void record(Operation operation, uint64_t ticks)
+    {
+        ThreadBuffer &buffer = local();
+        size_t index = static_cast<size_t>(operation);
+        bump(buffer.buckets[index][bucketOf(ticks)]);
+        bump(buffer.calls[index]);
+        if (ticks > buffer.maxTicks[index].load(std::memory_order_relaxed))
+        {
+            buffer.maxTicks[index].store(ticks, std::memory_order_relaxed);
+        }
+    }
+    // One row per operation that has been called: calls, calls per second
+    // since the first recorded call, and p50/p99/p999/max latency in microseconds
+    void write(std::ostream &out)
+    {
+        static const char *const names[operationCount] = {"Add CTO", "Add Member", "Modify Member",
+                                                          "Remove Member", "Display", "Top CTO"};
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        // Ticks per microsecond, measured against the steady clock over the
+        // whole run; very short runs wait a moment for a usable measurement
+        while (seconds < 0.01)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        }
+        double ticksPerMicro = static_cast<double>(now() - startTicks) / (seconds * 1e6);
+
+        std::vector<uint64_t> merged(bucketCount);
+        ReportWriter report(out);
+        report.column("Operation", 15).column("Calls", 12).column("Calls/s", 12).column("p50 us", 12);
+        report.column("p99 us", 12).column("p999 us", 12).column("Max us", 12).endRow();
+        report.repeat('-', 87).endRow();
+        std::lock_guard<std::mutex> guard(lock);
+        for (size_t index = 0; index < operationCount; ++index)
+        {
+            uint64_t calls = 0, maxTicks = 0;
+            std::fill(merged.begin(), merged.end(), 0);
+            for (const auto &buffer : buffers)
+            {
+                for (size_t bucket = 0; bucket < bucketCount; ++bucket)
+                {
+                    merged[bucket] += buffer->buckets[index][bucket].load(std::memory_order_relaxed);
+                }
+                calls += buffer->calls[index].load(std::memory_order_relaxed);
+                maxTicks = std::max(maxTicks, buffer->maxTicks[index].load(std::memory_order_relaxed));
+            }
+            if (calls == 0)
+            {
+                continue;
+            }
+            report.column(names[index], 15).column(std::to_string(calls), 12);
+            report.column(static_cast<double>(calls) / seconds, 12);
+            size_t bucket = 0;
+            uint64_t seen = merged[0];
+            for (double quantile : {0.5, 0.99, 0.999})
+            {
+                uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(calls))));
+                while (seen < rank && bucket + 1 < bucketCount)
+                {
+                    seen += merged[++bucket];
+                }
+                uint64_t ticks = std::min(highestIn(bucket), maxTicks);
+                report.column(static_cast<double>(ticks) / ticksPerMicro, 12);
+            }
+            report.column(static_cast<double>(maxTicks) / ticksPerMicro, 12).endRow();
+        }
+    }
+};
+
+// The stats shared by every thread in the program
+OperationStats &operationStats()
+{
+    static OperationStats stats;
+    return stats;
+}
+
+// Records the time from construction to destruction against one operation
+class OperationTimer
+{
+    Operation operation;
+    uint64_t start;
 
 public:
-    virtual void displayInfo() const = 0;
-    virtual ~Employee() = default;
+    explicit OperationTimer(Operation op) : operation(op), start(OperationStats::now()) {}
+    ~OperationTimer()
+    {
+        operationStats().record(operation, OperationStats::now() - start);
+    }
 };
 
-// Class for Team Members
-class TeamMember : public Employee
+// Prints the rows from a ranking or filter query as one table
+void displayMemberRows(const std::vector<MemberRow> &rows)
 {
-    std::string job;
-    int hoursWorked;
-    double contribution;
+    ReportWriter report(std::cout);
+    report.column("CTO", 15).column("Name", 15).column("Job", 20).column("Hours", 10).column("Contribution", 15).endRow();
+    report.repeat('-', 75).endRow();
+    for (const auto &row : rows)
+    {
+        report.column(row.cto->getName(), 15);
+        row.member.writeReport(report);
+    }
+}
 
-public:
-    TeamMember(std::string n, std::string j, int h, double c) : job(j), hoursWorked(h), contribution(c)
+// Prints countMembersWithJob's per-CTO counts and their total
+void displayJobCounts(std::string_view job, const std::vector<std::pair<const CTO *, size_t>> &counts)
+{
+    ReportWriter report(std::cout);
+    report.text("Job: ").text(job).endRow();
+    report.column("CTO", 15).column("Members", 10).endRow();
+    report.repeat('-', 25).endRow();
+    size_t total = 0;
+    for (const auto &[cto, count] : counts)
     {
-        name = n;
+        report.column(cto->getName(), 15).column(count, 10).endRow();
+        total += count;
     }
-    void displayInfo() const override
+    report.column("Total", 15).column(total, 10).endRow();
+}
+
+// Prints the results of a name search as one table
+void displayNameMatches(const std::vector<NameMatch> &matches)
+{
+    ReportWriter report(std::cout);
+    report.column("Name", 20).column("Role", 8).column("CTO", 15).column("Edits", 6).endRow();
+    report.repeat('-', 49).endRow();
+    for (const auto &match : matches)
     {
-        std::cout << std::setw(15) << name
-                  << std::setw(20) << job
-                  << std::setw(10) << hoursWorked
-                  << std::setw(15) << contribution << std::endl;
+        report.column(match.name, 20).column(match.cto->isValid(match.member) ? "Member" : "CTO", 8);
+        report.column(match.cto->getName(), 15).column(static_cast<int>(match.distance), 6).endRow();
     }
-    std::string getName() const
+}
+
+// After a name that was not found, lists the CTOs (or, given within, the
+// members of within) whose names are a typo or two away from it
+void suggestNames(CEO &ceo, const std::string &typed, const CTO *within = nullptr)
+{
+    std::vector<std::string> suggestions;
+    for (const NameMatch &match : ceo.findSimilarNames(typed, typed.size() <= 4 ? 1 : 2, 100))
     {
-        return name;
+        bool isMember = match.cto->isValid(match.member);
+        if (suggestions.size() < 5 && (within ? isMember && match.cto == within : !isMember))
+        {
+            suggestions.push_back(match.name);
+        }
     }
-    double getContribution() const
+    if (!suggestions.empty())
     {
-        return contribution;
+        std::cout << "Did you mean: ";
+        for (size_t i = 0; i < suggestions.size(); ++i)
+        {
+            std::cout << (i ? ", " : "") << suggestions[i];
+        }
+        std::cout << "?\n";
     }
-    void modifyJob(const std::string &newJob)
+}
+
+// Reads a page order: storage, hours or contribution, with a leading '-'
+// for largest first
+bool parsePageOrder(std::string_view text, PageRequest &request)
+{
+    request.descending = !text.empty() && text[0] == '-';
+    if (request.descending)
     {
-        job = newJob;
+        text.remove_prefix(1);
     }
-    void modifyHours(int newHours)
+    if (text == "storage" && !request.descending)
     {
-        hoursWorked = newHours;
+        request.order = PageRequest::Order::Storage;
     }
-    void modifyContribution(double newContribution)
+    else if (text == "hours")
     {
-        contribution = newContribution;
+        request.order = PageRequest::Order::Hours;
     }
-};
+    else if (text == "contribution")
+    {
+        request.order = PageRequest::Order::Contribution;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
 
-// Class for CTOs
-class CTO : public Employee
+// Remembers the last CTO a batch named, so a run of commands for one CTO
+// resolves it through a handle instead of hashing the name on every line
+struct BatchCTOCache
 {
-    std::string field;
-    std::vector<TeamMember> team;
+    std::string name;
+    CTOHandle handle;
 
-public:
-    CTO(std::string n, std::string f) : field(f)
+    CTO *lookup(CEO &ceo, std::string_view ctoName)
     {
-        name = n;
+        if (ctoName != name)
+        {
+            name = ctoName;
+            handle = ceo.findCTO(name);
+        }
+        CTO *cto = ceo.getCTO(handle);
+        if (!cto)
+        {
+            // Added since the last lookup, or the org was reloaded
+            handle = ceo.findCTO(name);
+            cto = ceo.getCTO(handle);
+        }
+        return cto;
     }
-    void addTeamMember(const TeamMember &member)
+};
+
+// Runs one batch command line; returns an error message, or nullptr on success.
+// operation is set to the menu operation the command ran, if any, for the stats.
+const char *runBatchCommand(CEO &ceo, BatchCTOCache &ctos, std::string_view line, Operation &operation)
+{
+    size_t space = line.find(' ');
+    std::string_view command = line.substr(0, space);
+    std::string_view args = space == std::string_view::npos ? std::string_view() : line.substr(space + 1);
+    std::string_view fields[5];
+
+    if (command == "ADD_CTO")
     {
-        team.push_back(member);
+        if (splitFields(args, fields, 2) != 2)
+        {
+            return "expected ADD_CTO name|field";
+        }
+        operation = Operation::AddCTO;
+        ceo.addCTO(CTO(std::string(fields[0]), fields[1]));
     }
-    void displayInfo() const override
+    else if (command == "ADD_MEMBER" || command == "MODIFY_MEMBER")
     {
-        std::cout << "CTO: " << name << " - Field: " << field << std::endl;
-        std::cout << std::setw(15) << "Name"
-                  << std::setw(20) << "Job"
-                  << std::setw(10) << "Hours"
-                  << std::setw(15) << "Contribution" << std::endl;
-        std::cout << std::string(60, '-') << std::endl;
-        for (const auto &member : team)
+        int hours;
+        double contribution;
+        if (splitFields(args, fields, 5) != 5)
+        {
+            return "expected cto|name|job|hours|contribution";
+        }
+        // nan would break the ordering of the CTO leaderboard
+        if (!parseNumber(fields[3], hours) || !parseNumber(fields[4], contribution) || !std::isfinite(contribution))
+        {
+            return "invalid hours or contribution";
+        }
+        CTO *cto = ctos.lookup(ceo, fields[0]);
+        if (!cto)
+        {
+            return "CTO not found";
+        }
+        if (command == "ADD_MEMBER")
+        {
+            operation = Operation::AddMember;
+            cto->addNewMember(TeamMember(std::string(fields[1]), std::string(fields[2]), hours, contribution));
+        }
+        else
         {
-            member.displayInfo();
+            operation = Operation::ModifyMember;
+            if (!cto->modifyTeamMember(std::string(fields[1]), std::string(fields[2]), hours, contribution))
+            {
+                return "team member not found";
+            }
         }
     }
-    std::string getName() const
+    else if (command == "REMOVE_MEMBER")
     {
-        return name;
+        if (splitFields(args, fields, 2) != 2)
+        {
+            return "expected REMOVE_MEMBER cto|name";
+        }
+        CTO *cto = ctos.lookup(ceo, fields[0]);
+        if (!cto)
+        {
+            return "CTO not found";
+        }
+        operation = Operation::RemoveMember;
+        if (cto->removeTeamMember(std::string(fields[1])) == 0)
+        {
+            return "team member not found";
+        }
     }
-    double getTotalContribution() const
+    else if (command == "TRANSFER")
     {
-        double total = 0;
-        for (const auto &member : team)
+        size_t bar = args.find('|');
+        size_t members = bar == std::string_view::npos ? bar : args.find('|', bar + 1);
+        if (members == std::string_view::npos)
         {
-            total += member.getContribution();
+            return "expected TRANSFER from|to|member[|member...]";
         }
-        return total;
+        CTOHandle from = ceo.findCTO(std::string(args.substr(0, bar)));
+        CTOHandle to = ceo.findCTO(std::string(args.substr(bar + 1, members - bar - 1)));
+        CTO *source = ceo.getCTO(from);
+        if (!source || !ceo.getCTO(to))
+        {
+            return "CTO not found";
+        }
+        if (from.position == to.position)
+        {
+            return "members are already in that CTO";
+        }
+        std::vector<MemberTransfer> moves;
+        while (members != std::string_view::npos)
+        {
+            size_t next = args.find('|', members + 1);
+            std::string_view memberName = args.substr(members + 1, next == std::string_view::npos ? next : next - members - 1);
+            MemberHandle member = source->findMember(std::string(memberName));
+            if (!source->isValid(member))
+            {
+                return "team member not found";
+            }
+            moves.push_back({from, member, to});
+            members = next;
+        }
+        if (!ceo.transferMembers(moves))
+        {
+            return "team member listed twice";
+        }
+    }
+    else if (command == "DISPLAY")
+    {
+        operation = Operation::Display;
+        ceo.displayInfo();
+    }
+    else if (command == "TOP_CTO")
+    {
+        operation = Operation::TopCTO;
+        ceo.determineTopCTO();
     }
-    void addNewMember(const TeamMember &member)
+    else if (command == "STATS")
     {
-        team.push_back(member);
+        operationStats().write(std::cout);
     }
-    void modifyTeamMember(const std::string &memberName, const std::string &newJob, int newHours, double newContribution)
+    else if (command == "DISPLAY_PAGE")
     {
-        for (auto &member : team)
+        PageRequest request;
+        size_t count = splitFields(args, fields, 4);
+        if (count > 4 || !parseNumber(fields[0], request.pageSize) ||
+            (count > 1 && !parseNumber(fields[1], request.offset)) ||
+            (count > 3 && !parsePageOrder(fields[3], request)))
+        {
+            return "expected DISPLAY_PAGE size[|offset[|cto[|order]]]";
+        }
+        if (count > 2)
         {
-            if (member.getName() == memberName)
+            request.cto = std::string(fields[2]);
+            if (!request.cto.empty() && !ctos.lookup(ceo, fields[2]))
             {
-                member.modifyJob(newJob);
-                member.modifyHours(newHours);
-                member.modifyContribution(newContribution);
-                break;
+                return "CTO not found";
             }
         }
+        ReportWriter report(std::cout);
+        ceo.writePage(report, request);
     }
-    void removeTeamMember(const std::string &memberName)
+    else if (command == "TOP_MEMBERS")
     {
-        team.erase(std::remove_if(team.begin(), team.end(), [&](const TeamMember &member)
-                                  { return member.getName() == memberName; }),
-                   team.end());
+        size_t count = splitFields(args, fields, 2);
+        size_t k;
+        if (count > 2 || !parseNumber(fields[0], k))
+        {
+            return "expected TOP_MEMBERS k or TOP_MEMBERS k|cto";
+        }
+        if (count == 1)
+        {
+            displayMemberRows(ceo.getTopMembers(k));
+        }
+        else if (CTO *cto = ctos.lookup(ceo, fields[1]))
+        {
+            displayMemberRows(cto->getTopMembers(k));
+        }
+        else
+        {
+            return "CTO not found";
+        }
     }
-};
-
-// Class for CEO
-class CEO : public Employee
-{
-    std::vector<CTO> ctoList;
-
-public:
-    CEO(std::string n)
+    else if (command == "FIND_JOB")
     {
-        name = n;
+        displayMemberRows(ceo.findMembersWithJob(args));
     }
-    void addCTO(const CTO &cto)
+    else if (command == "COUNT_JOB")
     {
-        ctoList.push_back(cto);
+        displayJobCounts(args, ceo.countMembersWithJob(args));
     }
-    void displayInfo() const override
+    else if (command == "COMPLETE")
     {
-        std::cout << "CEO: " << name << std::endl;
-        for (const auto &cto : ctoList)
+        size_t count = splitFields(args, fields, 2);
+        size_t k = 10;
+        if (count > 2 || (count == 2 && !parseNumber(fields[1], k)))
         {
-            cto.displayInfo();
-            std::cout << std::endl;
+            return "expected COMPLETE prefix[|k]";
         }
+        displayNameMatches(ceo.completeName(fields[0], k));
     }
-    CTO *getCTO(const std::string &ctoName)
+    else if (command == "SEARCH")
     {
-        for (auto &cto : ctoList)
+        size_t count = splitFields(args, fields, 3);
+        uint32_t maxDistance = 2;
+        size_t k = 10;
+        if (count > 3 || (count > 1 && !parseNumber(fields[1], maxDistance)) || (count > 2 && !parseNumber(fields[2], k)))
         {
-            if (cto.getName() == ctoName)
-            {
-                return &cto;
-            }
+            return "expected SEARCH name[|edits[|k]]";
         }
-        return nullptr;
+        displayNameMatches(ceo.findSimilarNames(fields[0], maxDistance, k));
     }
-    void determineTopCTO()
+    else if (command == "HOURS_RANGE" || command == "CONTRIBUTION_RANGE")
     {
-        if (ctoList.empty())
+        size_t count = splitFields(args, fields, 3);
+        double lo, hi;
+        if (count < 2 || count > 3 || (count == 3 && fields[2] != "count") || !parseNumber(fields[0], lo) ||
+            !parseNumber(fields[1], hi) || std::isnan(lo) || std::isnan(hi))
         {
-            std::cout << "No CTOs available to determine the top contributor.\n";
-            return;
+            return "expected lo|hi or lo|hi|count";
+        }
+        bool byHours = command == "HOURS_RANGE";
+        if (byHours)
+        {
+            // Whole hours inside [lo, hi], clamped to the int range
+            lo = std::max(std::ceil(lo), static_cast<double>(std::numeric_limits<int>::min()));
+            hi = std::min(std::floor(hi), static_cast<double>(std::numeric_limits<int>::max()));
+        }
+        if (count == 2)
+        {
+            displayMemberRows(byHours ? ceo.findByHours(static_cast<int>(lo), static_cast<int>(hi))
+                                      : ceo.findByContribution(lo, hi));
+        }
+        size_t matches = byHours ? ceo.countByHours(static_cast<int>(lo), static_cast<int>(hi))
+                                 : ceo.countByContribution(lo, hi);
+        std::cout << matches << " team members in range\n";
+    }
+    else if (command == "SAVE")
+    {
+        if (!ceo.saveSnapshot(std::string(args)))
+        {
+            return "cannot save snapshot";
+        }
+    }
+    else if (command == "LOAD")
+    {
+        if (!ceo.loadSnapshot(std::string(args)))
+        {
+            return "cannot load snapshot";
+        }
+    }
+    else if (command == "IMPORT")
+    {
+        ImportStats stats;
+        if (!importCSV(ceo, std::string(args), std::thread::hardware_concurrency(), stats))
+        {
+            return "cannot read CSV file";
+        }
+        printImportStats(stats);
+    }
+    else if (command == "COMPACT")
+    {
+        if (!ceo.compactLog(std::string(args)))
+        {
+            return "cannot compact the log (is --wal set?)";
         }
+    }
+    else
+    {
+        return "unknown command";
+    }
+    return nullptr;
+}
 
-        auto topCTO = std::max_element(ctoList.begin(), ctoList.end(), [](const CTO &a, const CTO &b)
-                                       { return a.getTotalContribution() < b.getTotalContribution(); });
+// Applies a command stream without prompts, one command per line:
+//   ADD_CTO name|field
+//   ADD_MEMBER cto|name|job|hours|contribution
+//   MODIFY_MEMBER cto|name|job|hours|contribution
+//   REMOVE_MEMBER cto|name
+//   TRANSFER from|to|member[|member...]   (moves the members, with their job,
+//                 hours and contribution, to another CTO in one step)
+//   DISPLAY
+//   TOP_CTO
+//   STATS         (calls, throughput and latency percentiles per operation above)
+//   DISPLAY_PAGE size[|offset[|cto[|order]]]   (one page of members; order is
+//                 storage, hours, contribution, -hours or -contribution)
+//   TOP_MEMBERS k[|cto]   (the k best contributors in the org, or in one CTO)
+//   FIND_JOB title        (every member with that job title)
+//   COUNT_JOB title       (members with that job title per CTO)
+//   HOURS_RANGE lo|hi[|count]          (members with lo <= hours <= hi, or just how many)
+//   CONTRIBUTION_RANGE lo|hi[|count]   (the same for contribution)
+//   COMPLETE prefix[|k]        (CTOs and members whose names start with prefix)
+//   SEARCH name[|edits[|k]]    (names within edits typos of name, 2 by default)
+//   SAVE path
+//   LOAD path
+//   COMPACT path   (fold the write-ahead log into a snapshot at path)
+//   IMPORT path    (CSV rows of cto,field,member,job,hours,contribution)
+// Blank lines and lines starting with '#' are skipped. Errors are reported
+// with their line number and do not stop the batch.
+int runBatch(CEO &ceo, const char *path)
+{
+    bool fromStdin = std::strcmp(path, "-") == 0;
+    std::FILE *in = fromStdin ? stdin : std::fopen(path, "rb");
+    if (!in)
+    {
+        std::cerr << "Cannot open batch file: " << path << "\n";
+        return 1;
+    }
+    std::ios::sync_with_stdio(false);
 
-        std::cout << "\nThe CTO whose team contributed the most is: " << topCTO->getName()
-                  << " with a total contribution of " << topCTO->getTotalContribution() << ".\n";
-        name = topCTO->getName();
+    BatchReader reader(in);
+    BatchCTOCache ctos;
+    std::string_view line;
+    size_t lineNumber = 0, commands = 0, errors = 0;
+    auto start = std::chrono::steady_clock::now();
+    // One timestamp per command, ending the previous command's interval, so a
+    // command's latency includes reading and parsing its line. Skipped lines
+    // restart the interval, so comments are not billed to the next command.
+    OperationStats &stats = operationStats();
+    uint64_t lastTick = OperationStats::now();
+    while (reader.nextLine(line))
+    {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#')
+        {
+            lastTick = OperationStats::now();
+            continue;
+        }
+        ++commands;
+        Operation operation = Operation::Count;
+        const char *error = runBatchCommand(ceo, ctos, line, operation);
+        uint64_t tick = OperationStats::now();
+        if (operation != Operation::Count)
+        {
+            stats.record(operation, tick - lastTick);
+        }
+        lastTick = tick;
+        if (error)
+        {
+            ++errors;
+            std::cerr << "Line " << lineNumber << ": " << error << "\n";
+        }
     }
-};
+    if (!ceo.commitLog())
+    {
+        ++errors;
+        std::cerr << "Cannot write the log\n";
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!fromStdin)
+    {
+        std::fclose(in);
+    }
+
+    std::cout.flush();
+    std::cerr << "Processed " << commands << " commands (" << errors << " errors) in "
+              << seconds << " s, " << (seconds > 0 ? commands / seconds : 0) << " commands/s\n";
+    return errors == 0 ? 0 : 1;
+}
 
 void displayMenu()
 {
@@ -183,12 +5379,85 @@ void displayMenu()
     std::cout << "5. Display Organization\n";
     std::cout << "6. Determine Top-Contributing CTO\n";
     std::cout << "7. Exit\n";
+    std::cout << "8. Save Organization Snapshot\n";
+    std::cout << "9. Load Organization Snapshot\n";
+    std::cout << "10. Compact Log into Snapshot\n";
+    std::cout << "11. Import CSV File\n";
+    std::cout << "12. Find Team Members by Job\n";
+    std::cout << "13. Browse Organization by Page\n";
+    std::cout << "14. Show Operation Stats\n";
+    std::cout << "15. Search Names\n";
     std::cout << "Enter your choice: ";
 }
 
-int main()
+#ifndef EMS_NO_MAIN // benchmark.cpp and microbench.cpp include this file and bring their own main
+int main(int argc, char *argv[])
 {
     CEO ceo("Your Company CEO");
+
+    // Options, in any order:
+    //   --load snapshot    start from a saved organization instead of an empty one
+    //   --wal log          replay log on top of that and log every later change
+    //   --group-commit N   log records per fsync (default 64)
+    //   --batch [file]     apply a command file (or stdin) instead of showing the menu
+    //   --stats            print per-operation latency stats to stderr on exit
+    const char *snapshotPath = nullptr;
+    const char *logPath = nullptr;
+    const char *batchPath = nullptr;
+    size_t groupCommit = 64;
+    bool dumpStats = false;
+    operationStats(); // Throughput is measured from here
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        bool hasValue = arg + 1 < argc && std::strncmp(argv[arg + 1], "--", 2) != 0;
+        if (std::strcmp(argv[arg], "--load") == 0 && hasValue)
+        {
+            snapshotPath = argv[++arg];
+        }
+        else if (std::strcmp(argv[arg], "--wal") == 0 && hasValue)
+        {
+            logPath = argv[++arg];
+        }
+        else if (std::strcmp(argv[arg], "--group-commit") == 0 && hasValue)
+        {
+            groupCommit = std::strtoul(argv[++arg], nullptr, 10);
+        }
+        else if (std::strcmp(argv[arg], "--batch") == 0)
+        {
+            batchPath = hasValue ? argv[++arg] : "-";
+        }
+        else if (std::strcmp(argv[arg], "--stats") == 0)
+        {
+            dumpStats = true;
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << argv[arg] << "\n";
+            return 1;
+        }
+    }
+
+    // With a log, a missing snapshot just means nothing has been compacted yet
+    if (snapshotPath && !(logPath && !std::filesystem::exists(snapshotPath)) && !ceo.loadSnapshot(snapshotPath))
+    {
+        std::cerr << "Cannot load snapshot: " << snapshotPath << "\n";
+        return 1;
+    }
+    if (logPath && !ceo.openLog(logPath, groupCommit))
+    {
+        std::cerr << "Cannot open log: " << logPath << "\n";
+        return 1;
+    }
+    if (batchPath)
+    {
+        int status = runBatch(ceo, batchPath);
+        if (dumpStats)
+        {
+            operationStats().write(std::cerr);
+        }
+        return status;
+    }
+
     int choice;
 
     do
@@ -206,6 +5475,7 @@ int main()
             std::getline(std::cin, ctoName);
             std::cout << "Enter Field of Expertise: ";
             std::getline(std::cin, field);
+            OperationTimer timer(Operation::AddCTO);
             ceo.addCTO(CTO(ctoName, field));
             break;
         }
@@ -228,11 +5498,13 @@ int main()
                 std::cout << "Enter Contribution Amount: ";
                 std::cin >> contribution;
                 std::cin.ignore(); // Clear input buffer
+                OperationTimer timer(Operation::AddMember);
                 cto->addNewMember(TeamMember(memberName, job, hours, contribution));
             }
             else
             {
                 std::cout << "CTO not found!\n";
+                suggestNames(ceo, ctoName);
             }
             break;
         }
@@ -255,11 +5527,17 @@ int main()
                 std::cout << "Enter New Contribution Amount: ";
                 std::cin >> newContribution;
                 std::cin.ignore(); // Clear input buffer
-                cto->modifyTeamMember(memberName, newJob, newHours, newContribution);
+                OperationTimer timer(Operation::ModifyMember);
+                if (!cto->modifyTeamMember(memberName, newJob, newHours, newContribution))
+                {
+                    std::cout << "Team member not found!\n";
+                    suggestNames(ceo, memberName, cto);
+                }
             }
             else
             {
                 std::cout << "CTO not found!\n";
+                suggestNames(ceo, ctoName);
             }
             break;
         }
@@ -273,16 +5551,29 @@ int main()
             {
                 std::cout << "Enter Team Member Name: ";
                 std::getline(std::cin, memberName);
-                cto->removeTeamMember(memberName);
+                OperationTimer timer(Operation::RemoveMember);
+                if (cto->removeTeamMember(memberName) == 0)
+                {
+                    std::cout << "Team member not found!\n";
+                    suggestNames(ceo, memberName, cto);
+                }
             }
             else
             {
                 std::cout << "CTO not found!\n";
+                suggestNames(ceo, ctoName);
             }
             break;
         }
+        case 5:
+        {
+            OperationTimer timer(Operation::Display);
+            ceo.displayInfo();
+            break;
+        }
         case 6:
         {
+            OperationTimer timer(Operation::TopCTO);
             ceo.determineTopCTO(); // Correct method to determine top CTO
             break;
         }
@@ -291,10 +5582,155 @@ int main()
             std::cout << "Exiting...\n";
             break;
         }
+        case 8:
+        {
+            std::string path;
+            std::cout << "Enter Snapshot File: ";
+            std::getline(std::cin, path);
+            if (ceo.saveSnapshot(path))
+            {
+                std::cout << "Organization saved.\n";
+            }
+            else
+            {
+                std::cout << "Could not save the snapshot!\n";
+            }
+            break;
+        }
+        case 9:
+        {
+            std::string path;
+            std::cout << "Enter Snapshot File: ";
+            std::getline(std::cin, path);
+            if (ceo.loadSnapshot(path))
+            {
+                std::cout << "Organization loaded.\n";
+            }
+            else
+            {
+                std::cout << "Could not load the snapshot!\n";
+            }
+            break;
+        }
+        case 10:
+        {
+            std::string path;
+            std::cout << "Enter Snapshot File: ";
+            std::getline(std::cin, path);
+            if (ceo.compactLog(path))
+            {
+                std::cout << "Log compacted.\n";
+            }
+            else
+            {
+                std::cout << "Could not compact the log! Start with --wal to keep one.\n";
+            }
+            break;
+        }
+        case 11:
+        {
+            std::string path;
+            ImportStats stats;
+            std::cout << "Enter CSV File: ";
+            std::getline(std::cin, path);
+            if (importCSV(ceo, path, std::thread::hardware_concurrency(), stats))
+            {
+                printImportStats(stats);
+            }
+            else
+            {
+                std::cout << "Could not read the CSV file!\n";
+            }
+            break;
+        }
+        case 12:
+        {
+            std::string job;
+            std::cout << "Enter Job: ";
+            std::getline(std::cin, job);
+            std::vector<MemberRow> rows = ceo.findMembersWithJob(job);
+            if (rows.empty())
+            {
+                std::cout << "No team members with that job!\n";
+            }
+            else
+            {
+                displayJobCounts(job, ceo.countMembersWithJob(job));
+                displayMemberRows(rows);
+            }
+            break;
+        }
+        case 13:
+        {
+            PageRequest request;
+            std::string order;
+            std::cout << "Enter CTO Name (empty for all): ";
+            std::getline(std::cin, request.cto);
+            std::cout << "Sort by (storage, hours, contribution, -hours, -contribution): ";
+            std::getline(std::cin, order);
+            std::cout << "Enter Page Size: ";
+            std::cin >> request.pageSize;
+            std::cin.ignore(); // Clear input buffer
+            if (!parsePageOrder(order.empty() ? "storage" : order, request) || request.pageSize == 0)
+            {
+                std::cout << "Invalid sort order or page size!\n";
+                break;
+            }
+            if (!request.cto.empty() && !ceo.getCTO(request.cto))
+            {
+                std::cout << "CTO not found!\n";
+                suggestNames(ceo, request.cto);
+                break;
+            }
+            std::string next;
+            do
+            {
+                size_t total;
+                {
+                    ReportWriter report(std::cout);
+                    total = ceo.writePage(report, request);
+                }
+                request.offset += request.pageSize;
+                if (request.offset >= total)
+                {
+                    break;
+                }
+                std::cout << "Enter for the next page, q to stop: ";
+                std::getline(std::cin, next);
+            } while (next != "q");
+            break;
+        }
+        case 14:
+            operationStats().write(std::cout);
+            break;
+        case 15:
+        {
+            std::string text;
+            std::cout << "Enter Name or Prefix: ";
+            std::getline(std::cin, text);
+            std::vector<NameMatch> completions = ceo.completeName(text, 10);
+            std::vector<NameMatch> similar = ceo.findSimilarNames(text, 2, 10);
+            if (completions.empty() && similar.empty())
+            {
+                std::cout << "No matching names!\n";
+                break;
+            }
+            std::cout << "Names starting with \"" << text << "\":\n";
+            displayNameMatches(completions);
+            std::cout << "Similar names:\n";
+            displayNameMatches(similar);
+            break;
+        }
         default:
             std::cout << "Invalid choice! Please try again.\n";
         }
+        ceo.commitLog(); // Interactive changes are durable as soon as the menu returns
     } while (choice != 7);
 
+    if (dumpStats)
+    {
+        operationStats().write(std::cerr);
+    }
     return 0;
 }
+#endif